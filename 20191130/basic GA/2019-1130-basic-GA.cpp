@@ -8,6 +8,16 @@
 #include <set>
 #include <string>
 #include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+#include <memory>
+#include "../../maxcut/deadline.h" // 공용 제한 시간 서비스
+#include "../../maxcut/incumbent.h" // 최선의 해 anytime 출력
+#include "../../maxcut/diversity.h" // 개체군 다양성, 재시작 정책
+#include "../../maxcut/sliced.h" // 비트 슬라이스 일괄 평가
+#include "../../maxcut/path_relinking.h" // 상위 해 사이 path relinking
+#include "../../maxcut/bounds.h" // cut 상한, 이분 그래프 판정
 using namespace std;
 
 struct Edge {
@@ -50,10 +60,17 @@ class GA {
 	*/
 private:
 	mt19937 gen; // 난수 생성기
-	clock_t start_timestamp; // 프로그램 시작 시간
+	chrono::steady_clock::time_point start_timestamp; // 프로그램 시작 시간
+	maxcut::Deadline deadline; // 제한 시간: execute()에서 설정
+	maxcut::Incumbent* incumbent = nullptr; // 더 좋은 해가 나올 때마다 알려줄 대상(anytime 출력)
 	Graph graph; // 문제 그래프
+	vector<maxcut::Edge> cut_edges; // 일괄 평가용 간선 목록: 무방향 간선 하나씩, 0부터 시작하는 정점 번호
+	maxcut::Graph problem; // cut_edges로 만든 CSR 그래프: path relinking용
+	maxcut::SlicedCut sliced{ 0, vector<maxcut::Edge>() }; // problem의 일괄 평가기: execute()에서 한 번 만들어 계속 씀
 	/* 유전자 풀: 가중치에 따른 선택을 위해 카운팅 배열 방식으로 저장 */
 	map<int, vector<string>> pool; // 가중치, 해
+	maxcut::Diversity diversity; // pool의 자리별 'A' 개수: pool에 해가 들어오고 나갈 때마다 갱신
+	maxcut::RestartPolicy restart_policy{ 0.01, 50 }; // 다양성 1% 미만이거나 50세대 동안 개선이 없으면 재시작
 	vector<tuple<int, string>> temp_pool; // 임시 자식 풀: cost, 유전자
 	int thresh; // 부모 쌍 cost 차이 제한
 	tuple<int, string> sol; // 반환할 해
@@ -62,11 +79,21 @@ private:
 	// thresh 설정
 	void set_thresh(int thr) { thresh = thr; };
 	// 시간 초과 확인
-	bool is_timeout(int deadline, bool is_print = false);
+	bool is_timeout(bool is_print = false);
+	// incumbent에 해 제안
+	void offer(int cost, const string& chromosome);
 	// 현재 pool에서 가장 좋은 해 반환
 	tuple<int, string> get_current_best();
+	// pool에 해 추가
+	void add_to_pool(int cost, const string& chromosome);
+	// pool의 해가 n_total개가 될 때까지 랜덤 해 추가: 시간 초과시 false
+	bool fill_pool(int n_total);
+	// 재시작: 상위 해만 남기고 나머지는 랜덤 해로 다시 채움
+	bool restart(int n_total);
 	// 해 유효성 확인 및 cost 계산
 	int validate(string chromosome);
+	// 해 여러 개의 유효성 확인 및 cost 계산: 간선을 한 번 훑을 때 해 64개(AVX2면 256개)를 함께 계산
+	vector<int> validate_batch(const vector<string>& chromosomes);
 	// 해 생성
 	string generate();
 	// 부모 쌍 선택: 토너먼트 이용
@@ -75,8 +102,12 @@ private:
 	string crossover(string female, string male);
 	// 돌연변이
 	string mutation(string chromosome);
+	// 해와 그 보수(모든 문자를 바꾼 해)는 같은 cut: 0번 정점이 'B'인 쪽으로 통일
+	void canonicalize(string& chromosome);
 	// 세대 교체
 	bool replacement(string chromosome, int cost);
+	// pool 상위 해들을 최선의 해 쪽으로 path relinking: 최선보다 좋은 결과만 pool에 추가
+	void relink(int n_pairs);
 
 	// pool에 존재하는 모든 해의 cost 출력
 	void print_pool(int idx);
@@ -87,33 +118,35 @@ public:
 		random_device rd;
 		mt19937 g(rd());
 		this->gen = g;
-		start_timestamp = clock();
+		start_timestamp = chrono::steady_clock::now();
 	}
 	GA(Graph& graph) {
 		this->graph = graph;
 		random_device rd;
 		mt19937 g(rd());
 		this->gen = g;
-		start_timestamp = clock();
+		start_timestamp = chrono::steady_clock::now();
 	}
 	GA(Graph& graph, mt19937 gen) {
 		this->graph = graph;
 		this->gen = gen;
-		start_timestamp = clock();
+		start_timestamp = chrono::steady_clock::now();
 	}
-	GA(Graph& graph, clock_t start) {
+	GA(Graph& graph, chrono::steady_clock::time_point start) {
 		this->graph = graph;
 		random_device rd;
 		mt19937 g(rd());
 		this->gen = g;
 		start_timestamp = start;
 	}
-	GA(Graph& graph, mt19937 gen, clock_t start) {
+	GA(Graph& graph, mt19937 gen, chrono::steady_clock::time_point start) {
 		this->graph = graph;
 		this->gen = gen;
 		start_timestamp = start;
 	}
 
+	// anytime 출력 대상 설정
+	void set_incumbent(maxcut::Incumbent* incumbent) { this->incumbent = incumbent; }
 	// 유전 알고리즘 실행
 	tuple<int, string> execute(int due = 30);
 	// 해 문자열과 가중치 반환
@@ -133,9 +166,10 @@ int main()
 
 	//clock_start = clock();
 
-	// 제출용 입출력
+	// 제출용 입출력: 출력은 incumbent가 더 좋은 해가 나올 때마다 maxcut.out에 원자적으로 씀
 	ifstream input{ "maxcut.in" };
-	ofstream output{ "maxcut.out" };
+	maxcut::Incumbent incumbent{ "maxcut.out" };
+	maxcut::install_stop_handlers(&incumbent); // SIGINT/SIGTERM을 받으면 최선의 해를 쓰고 바로 종료
 
 	// 프로그램 실행 시작
 	int v, e; // 정점 수 v, 간선 수 e
@@ -158,8 +192,9 @@ int main()
 
 	// 유전 알고리즘 실행 후 결과 출력
 	agent = GA(graph);
+	agent.set_incumbent(&incumbent);
 	tuple<int, string> sol = agent.execute(due);
-	output << agent.to_string_solution() << "\n";
+	incumbent.flush(); // pool에 들어간 모든 해가 이미 제안되었으므로 incumbent가 최종 해
 
 	// 종료 시간 측정
 	//clock_finish = clock();
@@ -216,12 +251,10 @@ void Graph::print() {
 }
 
 // 제한 시간 초과 확인
-bool GA::is_timeout(int deadline, bool is_print) {
-	clock_t running_time = clock();
-	double time_len = (double)(running_time - start_timestamp) / CLOCKS_PER_SEC;
+bool GA::is_timeout(bool is_print) {
 	if (is_print)
-		cout << "current time: " << time_len << "\n";
-	if (time_len > deadline) {
+		cout << "current time: " << deadline.elapsed() << "\n";
+	if (deadline.expired()) {
 		if (is_print)
 			cout << "time over\n";
 		return true;
@@ -229,6 +262,13 @@ bool GA::is_timeout(int deadline, bool is_print) {
 	return false;
 }
 
+// incumbent에 해 제안: 출력은 vertex 1이 속한 부류
+void GA::offer(int cost, const string& chromosome) {
+	if (incumbent == nullptr || cost == INT_MIN)
+		return;
+	incumbent->offer(cost, chromosome.length(), [&](size_t i) { return chromosome[i] == chromosome[0]; });
+}
+
 // 현재 pool에서 가장 좋은 해 반환
 tuple<int, string> GA::get_current_best() {
 	for (map<int, vector<string>>::iterator i = --pool.end(); (i != pool.begin() || i == pool.begin()); --i) {
@@ -240,6 +280,58 @@ tuple<int, string> GA::get_current_best() {
 	return make_tuple(INT_MIN, "");
 }
 
+// pool에 해 추가
+void GA::add_to_pool(int cost, const string& chromosome) {
+	if (pool.find(cost) == pool.end()) { // 추가할 해의 cost가 pool에 없으면 추가
+		pool.insert({ cost, vector<string>() });
+	}
+	pool[cost].push_back(chromosome);
+	diversity.add([&](size_t i) { return chromosome[i] == 'A'; });
+	offer(cost, chromosome);
+}
+
+// pool의 해가 n_total개가 될 때까지 랜덤 해 추가
+bool GA::fill_pool(int n_total) {
+	while (diversity.size() < n_total) {
+		vector<string> chromosomes; // 모자란 만큼 한꺼번에 만들어 한 번에 평가
+		for (int i = int(diversity.size()); i < n_total; i++)
+			chromosomes.push_back(generate());
+		vector<int> costs = validate_batch(chromosomes);
+		for (size_t i = 0; i < chromosomes.size(); i++) {
+			if (costs[i] != INT_MIN) // 유효한 해만 pool에 추가
+				add_to_pool(costs[i], chromosomes[i]);
+		}
+		if (is_timeout())
+			return false;
+	}
+	return true;
+}
+
+// 재시작: cost가 큰 순서로 상위 해(elite)만 남기고 나머지는 랜덤 해로 다시 채움
+bool GA::restart(int n_total) {
+	size_t n_elites = maxcut::RestartPolicy::elite_count(n_total);
+	vector<tuple<int, string>> elites;
+
+	for (auto i = pool.rbegin(); i != pool.rend() && elites.size() < n_elites; ++i) {
+		for (auto& chromosome : i->second) {
+			if (elites.size() >= n_elites)
+				break;
+			elites.push_back(make_tuple(i->first, chromosome));
+		}
+	}
+
+	pool.clear();
+	diversity.clear();
+	for (auto& elite : elites)
+		add_to_pool(get<0>(elite), get<1>(elite));
+	if (!fill_pool(n_total))
+		return false;
+
+	// 자식 교체 대상 cost 차이 제한도 새 pool 기준으로 다시 설정
+	set_thresh(max(int(((--pool.end())->first - pool.begin()->first) * 0.2), 5));
+	return true;
+}
+
 // 해 유효성 검사 및 가중치 계산
 int GA::validate(string chromosome) {
 	/*
@@ -297,6 +389,22 @@ int GA::validate(string chromosome) {
 		return INT_MIN;
 }
 
+// 해 여러 개의 유효성 검사 및 가중치 계산: validate()와 같은 결과
+vector<int> GA::validate_batch(const vector<string>& chromosomes) {
+	vector<long long> costs(chromosomes.size());
+	unique_ptr<bool[]> crossing(new bool[chromosomes.size()]); // 두 부류를 잇는 간선이 하나라도 있는지
+	sliced.evaluate(chromosomes.size(), [&](size_t j, size_t i) { return chromosomes[j][i] == 'A'; },
+		costs.data(), crossing.get());
+
+	vector<int> result(chromosomes.size(), INT_MIN);
+	for (size_t j = 0; j < chromosomes.size(); j++) {
+		// 두 부류를 잇는 간선이 있으면 두 부류 모두 노드를 가지므로 유효한 해
+		if (chromosomes[j].length() == graph.size() && crossing[j])
+			result[j] = int(costs[j]);
+	}
+	return result;
+}
+
 // 랜덤 해 생성
 string GA::generate() {
 	int len = graph.size(); // 해의 길이
@@ -311,6 +419,7 @@ string GA::generate() {
 		}
 	}
 
+	canonicalize(chromosome);
 	return chromosome;
 }
 
@@ -397,9 +506,18 @@ string GA::crossover(string female, string male) {
 			child.push_back(male.at(i));
 		}
 	}
+	canonicalize(child);
 	return child;
 }
 
+// 0번 정점이 'A'이면 모든 문자를 바꿈: 같은 cut이 pool에 두 가지 모양으로 들어가지 않음
+void GA::canonicalize(string& chromosome) {
+	if (chromosome.empty() || chromosome[0] != 'A')
+		return;
+	for (char& c : chromosome)
+		c = (c == 'A' ? 'B' : 'A');
+}
+
 // 돌연변이
 string GA::mutation(string chromosome) {
 	uniform_int_distribution<int> is_mutate(1, 200 * this->graph.size()); // 돌연변이 발생 확률 조절
@@ -431,15 +549,58 @@ bool GA::replacement(string chromosome, int cost) {
 	s = pool[r_cost].size();
 
 	s = uniform_int_distribution<int>(0, s - 1)(this->gen); // 교체 대상의 인덱스 뽑기
+	const string& victim = pool[r_cost][s];
+	diversity.remove([&](size_t i) { return victim[i] == 'A'; });
 	pool[r_cost].erase(pool[r_cost].begin() + s); // 교체 대상 삭제
 
-	if (pool.find(cost) == pool.end()) { // 추가할 자식의 cost가 pool에 없으면 추가
-		pool.insert({ cost, vector<string>() });
-	}
-	pool[cost].push_back(chromosome); // 자식 추가
+	add_to_pool(cost, chromosome); // 자식 추가
 	return true; // 교체 성공
 }
 
+// pool 상위 해들을 최선의 해 쪽으로 path relinking
+void GA::relink(int n_pairs) {
+	// --pool.end()부터 최선의 해와 그다음 상위 해 n_pairs개
+	vector<vector<uint8_t>> elites;
+	for (auto i = pool.rbegin(); i != pool.rend() && int(elites.size()) <= n_pairs; ++i) {
+		for (const string& chromosome : i->second) {
+			if (int(elites.size()) > n_pairs)
+				break;
+			vector<uint8_t> sides(chromosome.length());
+			for (size_t v = 0; v < chromosome.length(); v++)
+				sides[v] = (chromosome[v] == 'A');
+			elites.push_back(sides);
+		}
+	}
+	vector<pair<size_t, size_t>> pairs; // 상위 해 j에서 최선의 해(0번) 쪽으로
+	for (size_t j = 1; j < elites.size(); j++)
+		pairs.push_back({ j, 0 });
+	if (pairs.empty())
+		return;
+
+	vector<vector<uint8_t>> results;
+	vector<long long> costs;
+	maxcut::relink_pairs(problem, elites, pairs, results, costs); // 쌍마다 스레드 하나
+
+	int best = get<0>(get_current_best());
+	vector<string> chromosomes;
+	for (auto& sides : results) {
+		string chromosome(sides.size(), 'B');
+		for (size_t v = 0; v < sides.size(); v++) {
+			if (sides[v])
+				chromosome[v] = 'A';
+		}
+		canonicalize(chromosome);
+		chromosomes.push_back(chromosome);
+	}
+	vector<int> result_costs = validate_batch(chromosomes);
+	for (size_t r = 0; r < chromosomes.size(); r++) {
+		if (result_costs[r] != INT_MIN && result_costs[r] > best) { // 최선의 해보다 좋을 때만 추가
+			best = result_costs[r];
+			add_to_pool(best, chromosomes[r]);
+		}
+	}
+}
+
 // pool에 존재하는 모든 해의 cost 출력
 void GA::print_pool(int idx) {
 	map<int, vector<string>>::iterator iter; // map iterator: https://dar0m.tistory.com/98
@@ -475,30 +636,46 @@ tuple<int, string> GA::execute(int due) { // due: 프로그램 실행 마감시
 	bool is_child_added = false; // 자식이 pool에 추가되었는지
 	int cut_count = 0; // 대체 실패한 자식 수
 
+	deadline = maxcut::Deadline(start_timestamp, due); // 프로그램 시작 시각부터 due초
+	diversity = maxcut::Diversity(this->graph.size());
+	cut_edges.clear();
+	for (const Edge& e : this->graph.edges_from()) {
+		if (e.from < e.to) // add_undir()가 양방향으로 넣은 간선은 한 번만
+			cut_edges.push_back(maxcut::Edge{ int(e.from) - 1, int(e.to) - 1, e.w });
+	}
+	problem = maxcut::Graph(this->graph.size(), cut_edges);
+	sliced = maxcut::SlicedCut(problem);
+	int n_generation = 0; // 세대 수
+
+	// cut 상한: 이분 그래프면 2-색칠이 최적해이므로 바로 끝냄
+	// 아니면 incumbent가 상한에 닿는 순간 deadline이 만료되어 남은 시간을 쓰지 않음
+	vector<uint8_t> colouring;
+	maxcut::CutBounds bounds = maxcut::cut_bounds(problem, colouring);
+	if (incumbent != nullptr)
+		incumbent->set_target(bounds.upper());
+	if (bounds.balanced) {
+		string chromosome(colouring.size(), 'B');
+		for (size_t v = 0; v < colouring.size(); v++) {
+			if (colouring[v])
+				chromosome[v] = 'A';
+		}
+		canonicalize(chromosome);
+		add_to_pool(validate(chromosome), chromosome);
+		return get_current_best();
+	}
+
 	//int idx = 1; // 세대 수
 
 	// 랜덤 해 생성
 	// cout << "generate\n";
-	for (int i = 0; i < 2 * n_pool; i++) { // 2 * n_pool 만큼 생성
-		string chromosome = generate();
-		int cost = validate(chromosome);
-		if (cost != INT_MIN) { // 유효한 해만 pool에 추가
-			if (pool.find(cost) == pool.end()) {
-				pool.insert({ cost, vector<string>() });
-			}
-			pool[cost].push_back(chromosome);
-		}
-		else
-			i--;
-		if (is_timeout(due)) {
-			return get_current_best();
-		}
+	if (!fill_pool(2 * n_pool)) { // 2 * n_pool 만큼 생성
+		return get_current_best();
 	}
 
 	//print_pool(idx++);
 
 	// cout << "generate complete\n";
-	if (is_timeout(due)) {
+	if (is_timeout()) {
 		return get_current_best();
 	}
 
@@ -508,7 +685,7 @@ tuple<int, string> GA::execute(int due) { // due: 프로그램 실행 마감시
 	// 부모 선택, 교배, 세대 교체
 	while (true) { // 조건을 만족할 때까지 진화, 제한 시간 임박하면 종료
 		// 시간 제한 확인
-		if (is_timeout(due)) {
+		if (is_timeout()) {
 			return get_current_best();
 		}
 
@@ -520,19 +697,23 @@ tuple<int, string> GA::execute(int due) { // due: 프로그램 실행 마감시
 
 		// 자식 생성
 		// cout << "generate children\n";
+		vector<string> children;
 		for (int i = 0; i < k; i++) {
 			// 부모 선택
 			tuple<string, int, string, int> parent = selection();
-			// 교배 및 유효성 확인
-			string child = crossover(get<0>(parent), get<2>(parent));
-			int child_cost = validate(child);
-			if (child_cost != INT_MIN) {
-				temp_pool.push_back(make_tuple(child_cost, child));
+			// 교배
+			children.push_back(crossover(get<0>(parent), get<2>(parent)));
+		}
+		// 유효성 확인: 한 세대의 자식을 한 번에 평가
+		vector<int> child_costs = validate_batch(children);
+		for (int i = 0; i < k; i++) {
+			if (child_costs[i] != INT_MIN) {
+				temp_pool.push_back(make_tuple(child_costs[i], children[i]));
 			}
 		}
 		// 시간 제한 확인
 		// cout << "children generation complete\n";
-		if (is_timeout(due)) {
+		if (is_timeout()) {
 			return get_current_best();
 		}
 
@@ -553,15 +734,23 @@ tuple<int, string> GA::execute(int due) { // due: 프로그램 실행 마감시
 
 		//print_pool(idx++);
 
+		// pool이 한 번 바뀔 만큼(20세대)마다 상위 해 4개를 최선의 해 쪽으로 path relinking
+		if (++n_generation % 20 == 0)
+			relink(4);
+
 		// 시간 제한 확인
 		// cout << "children replace complete\n";
-		if (is_timeout(due)) {
+		if (is_timeout()) {
 			return get_current_best();
 		}
 
-		if (cut_count > int(double(k) * 0.5)) { // 생성된 자식의 50% 이상이 대체되지 못했다면 진화 수렴 판단
-			// cout << "evolution complete\n";
-			break;
+		// 생성된 자식의 50% 이상이 대체되지 못했거나, 다양성이 줄었거나, 오래 개선이 없으면 진화 수렴 판단
+		bool is_converged = restart_policy.update(diversity.normalized(), get<0>(get_current_best()));
+		if (is_converged || cut_count > int(double(k) * 0.5)) {
+			// cout << "evolution converged: restart\n";
+			if (!restart(2 * n_pool)) { // 남은 시간 동안 상위 해를 유지한 채 다시 진화
+				return get_current_best();
+			}
 		}
 	}
 
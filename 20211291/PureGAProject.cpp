@@ -2,21 +2,29 @@
 #include <fstream>
 #include <string>
 #include <vector>
-#include <set>
 #include <algorithm>
 #include <cstdlib>
 #include <ctime>
 #include <chrono>
 #include <numeric>
 #include <cmath>
+#include <climits>
+#include <random>
+#include "../maxcut/deadline.h" // 공용 제한 시간 서비스
+#include "../maxcut/incumbent.h" // 최선의 해 anytime 출력
+#include "../maxcut/diversity.h" // 개체군 다양성, 재시작 정책
+#include "../maxcut/sliced.h" // 세대 전체를 한 번에 평가
+#include "../maxcut/tournament.h" // 한 세대의 토너먼트를 한 번에 진행
+#include "../maxcut/replacement.h" // (μ+λ), (μ,λ) 대치
 using namespace std;
 
 #define POP_SIZE 200 // 한 세대를 이루는 해의 총 개수
-#define GENERATIONS 1000 // 총 1000 세대
 #define TOURNAMENT_SIZE 0.14 // 토너먼트에 참여할 해의 비율
 #define TOURNAMENT_RATE 0.6 // 토너먼트 선택이 발생할 확률
 #define CROSSOVER_RATE 0.8 // 교차(교배)가 발생할 확률
 #define MUTATION_RATE 0.05 // 변이가 발생할 확률
+#define TIME_LIMIT 180.0 // 제한 시간(초): 반복 실행 전체가 나눠 씀
+#define REPLACEMENT 0 // 대치 방식: 0 generational, 1 (μ+λ) 현재+후속 세대 중 상위 POP_SIZE, 2 (μ,λ) 후속 세대 중 상위 POP_SIZE
 
 
 struct Edge {
@@ -24,18 +32,28 @@ struct Edge {
 };
 
 vector<vector<int>> population; // 한 세대를 이루는 해를 저장하는 컨테이너 생성
+vector<long long> population_costs; // population[i]의 적합도: 선택할 때 다시 계산하지 않도록 저장해 둠
 vector<Edge> edges; // <v1, v2, w>를 저장하는 컨테이너 생성
 int count_V, count_E; // 정점 개수, 간선 개수
+maxcut::Incumbent incumbent("maxcut.out"); // 모든 실행을 통틀어 가장 좋은 해: 좋아질 때마다 maxcut.out에 씀
+maxcut::TournamentBatch tournaments; // 토너먼트 일괄 진행기
+mt19937_64 rng; // 토너먼트 참가자 추첨용 난수 생성기
 
 
+vector<int> random_individual() { // 랜덤 해 하나 생성
+    vector<int> individual;
+    for (int j = 0; j < count_V; ++j) { // 0 또는 1로 이루어진 count_V 크기의 하나의 해 생성
+        individual.push_back(rand() % 2); // individual: 0과 1로 이루어짐
+    }
+    return individual;
+}
+
 void initialize_population() { // 해 생성
     srand(time(NULL));
+    rng.seed(time(NULL));
+    population.clear(); // 이전 실행의 해는 버림
     for (int i = 0; i < POP_SIZE; ++i) { 
-        vector<int> individual;
-        for (int j = 0; j < count_V; ++j) { // 0 또는 1로 이루어진 count_V 크기의 하나의 해 생성
-            individual.push_back(rand() % 2); // individual: 0과 1로 이루어짐
-        }
-        population.push_back(individual); // 생성한 해를 population 컨테이너에 추가
+        population.push_back(random_individual()); // 생성한 해를 population 컨테이너에 추가
     }
 }
 
@@ -49,30 +67,25 @@ int fitness (const vector<int>& individual) { // 적합도 계산
     return fitness; // 적합도 값을 반환
 }
 
-vector<int> tournament_selection() { // 부모 선택 - 토너먼트 선택 방식
-    set<int> chosen;
-    int tournament_num = (int) count_V * TOURNAMENT_SIZE;
-    while (chosen.size() < tournament_num) { 
-        chosen.insert(rand() % POP_SIZE); // 토너먼트에 참여할 해를 랜덤으로 선택 -> 이 중에서 parent가 나옴
-    }
-    double tournament_prob = (double) rand() / RAND_MAX;
-
-    if (tournament_prob < TOURNAMENT_RATE){ // 0.6보다 작으면 가장 좋은 해를 선택하여 반환
-        int best = *chosen.begin(); // 처음 선택된 자식의 index
-        for (const auto &idx : chosen) { // 가장 좋은 해를 찾는 for문 (이걸 좀 더 쉽게 쓸 수 있는 방법은 없나? aoto를 모르겠음)
-            if (fitness(population[idx]) > fitness(population[best])) { // 적합도를 비교하여 더 좋은 해가 있으면 그 해의 index로 갱신
-                best = idx;
-            }
+vector<size_t> tournament_selection() { // 부모 선택 - 토너먼트 선택 방식: 한 세대에 필요한 2 * POP_SIZE번을 한꺼번에
+    size_t tournament_num = max<size_t>(1, min<size_t>(size_t(count_V * TOURNAMENT_SIZE), population.size())); // 참가 해 수
+    vector<size_t> winners(2 * POP_SIZE); // 뽑힌 부모의 index
+    vector<size_t> best_slots; // 가장 좋은 해를 뽑을 자리
+    for (size_t t = 0; t < winners.size(); ++t) {
+        double tournament_prob = (double) rand() / RAND_MAX;
+        if (tournament_prob < TOURNAMENT_RATE) { // 0.6보다 작으면 토너먼트에서 가장 좋은 해를 선택
+            best_slots.push_back(t);
+        }
+        else { // 토너먼트 참가자 중 랜덤한 하나 = 전체에서 랜덤한 하나
+            winners[t] = rand() % population.size();
         }
-        return population[best]; // 가장 좋은 해(0과 1로 이루어진 individual)를 반환함
     }
-    else { // chosen에서 랜덤한 하나의 해를 선택하여 반환 
-        int ran = rand() % tournament_num;
-        auto ran_idx = chosen.begin();
-        advance(ran_idx, ran);
-
-        return population[*ran_idx];
+    vector<size_t> best(best_slots.size()); // 토너먼트별 가장 좋은 해: 저장해 둔 적합도만 비교
+    tournaments.run(population_costs.data(), population.size(), tournament_num, best.size(), rng, best.data(), nullptr);
+    for (size_t k = 0; k < best_slots.size(); ++k) {
+        winners[best_slots[k]] = best[k];
     }
+    return winners;
 }
 
 void crossover(vector<int>& parent1, vector<int>& parent2) { // 두 부모를 교차(교배)
@@ -133,17 +146,55 @@ void steady_state_replace(vector<vector<int>>& new_population) {
 }
 */
 
-void genetic_algorithm() {
-    auto start = chrono::steady_clock::now(); // start: 현재 시간
-    for (int gen = 0; gen < GENERATIONS; ++gen) {
+void restart_population(maxcut::SlicedCut& batch_fitness) { // 수렴한 세대에서 상위 해만 남기고 나머지는 랜덤 해로 다시 채움
+    // 상위 해는 저장해 둔 적합도를 그대로 쓰고, 새로 채운 해만 한 번에 계산
+    vector<int> order(population.size()); // 적합도 순서
+    iota(order.begin(), order.end(), 0);
+    size_t n_elites = min(maxcut::RestartPolicy::elite_count(POP_SIZE), order.size()); // 남길 상위 해의 수
+    partial_sort(order.begin(), order.begin() + n_elites, order.end(),
+        [&](int a, int b) { return population_costs[a] > population_costs[b]; });
+
+    vector<vector<int>> next_population;
+    vector<long long> next_costs; // next_population[i]의 적합도
+    for (size_t i = 0; i < n_elites; ++i) {
+        next_population.push_back(population[order[i]]);
+        next_costs.push_back(population_costs[order[i]]);
+    }
+    while (next_population.size() < POP_SIZE) {
+        next_population.push_back(random_individual());
+    }
+    next_costs.resize(next_population.size());
+    batch_fitness.evaluate(next_population.size() - n_elites,
+        [&](size_t j, size_t v) { return next_population[n_elites + j][v] == 1; }, next_costs.data() + n_elites);
+    population = next_population;
+    population_costs = next_costs;
+}
+
+void genetic_algorithm(double seconds) {
+    maxcut::Deadline deadline(seconds); // 제한 시간: 단조 시계 기준, 시그널을 받으면 바로 만료
+    maxcut::RestartPolicy restart_policy; // 다양성이 줄거나 오래 개선이 없으면 재시작
+    vector<maxcut::Edge> cut_edges; // 비트 슬라이스 평가용 간선 목록
+    for (const auto& edge : edges) {
+        cut_edges.push_back({ edge.v1, edge.v2, edge.w });
+    }
+    maxcut::SlicedCut batch_fitness(count_V, cut_edges); // 간선을 한 번 훑어 해 64개(AVX2면 256개)의 cut을 함께 계산
+    auto evaluate_population = [&]() { // 현재 세대의 적합도를 한 번에 계산해 저장
+        population_costs.resize(population.size());
+        batch_fitness.evaluate(population.size(),
+            [&](size_t j, size_t v) { return population[j][v] == 1; }, population_costs.data());
+    };
+    evaluate_population();
+    while (!deadline.expired()) { // 세대 수 제한 없이 제한 시간을 모두 사용
         vector<vector<int>> new_population; // 그 다음 후속 세대가 생성
+        vector<size_t> parents = tournament_selection(); // 이번 세대의 부모 index 2 * POP_SIZE개
+        bool is_over = false; // 세대 도중 시간 초과
         for (int i = 0; i < POP_SIZE; ++i) { 
-            vector<int> parent1 = tournament_selection(); 
-            vector<int> parent2 = tournament_selection();
-            if (parent1 == parent2){ // 똑같은 부모가 나오면 다시 부모를 선택함
-                vector<int> parent1 = tournament_selection(); 
-                vector<int> parent2 = tournament_selection();
+            if (deadline.expired()) { // 시간이 다 되면 만들던 세대는 버림
+                is_over = true;
+                break;
             }
+            vector<int> parent1 = population[parents[2 * i]]; 
+            vector<int> parent2 = population[parents[2 * i + 1]];
             crossover(parent1, parent2); // parent1과 parent2 교차(교배)
             mutate(parent1); // 교배했을 때 더 좋은 해(parent1)의 변이
             //mutate(parent2); // 교배했을 때 더 좋지 않은 해(parent2)의 변이
@@ -155,26 +206,36 @@ void genetic_algorithm() {
             */
             
         }
+        vector<long long> costs(new_population.size()); // 후속 세대의 적합도를 한 번에 계산
+        batch_fitness.evaluate(new_population.size(),
+            [&](size_t j, size_t v) { return new_population[j][v] == 1; }, costs.data());
+        for (size_t i = 0; i < new_population.size(); ++i) {
+            const vector<int>& child = new_population[i];
+            incumbent.offer(costs[i], count_V, [&](size_t j) { return child[j] == 1; }); // 더 좋은 해면 바로 출력
+        }
+        if (is_over) { // 마지막으로 완성된 세대를 유지하고 종료
+            break;
+        }
         //steady_state_replace(population, new_population); // steady-state 방식으로 대치
-        population = new_population; // generational GA 방식으로 대치
-
-        /*
-        // steady-state 방식으로 대치
-        population.insert(population.end(), new_population.begin(), new_population.end()); // 현재 세대와 후속 세대 결합
-
-        // fitness 값을 기준으로 결합된 세대를 정렬함
-        sort(population.begin(), population.end(),
-            [](const vector<int>& a, const vector<int>& b) {
-                return fitness(a) > fitness(b);
-            });
-
-        // 상위 POP_SIZE(세대에 속하는 해의 개수) 만큼이 새로운 후속 세대가 됨
-        population.resize(POP_SIZE);
-        */
+        if (REPLACEMENT == 0) {
+            population = new_population; // generational GA 방식으로 대치
+            population_costs = costs;
+        }
+        else {
+            // 저장해 둔 적합도로 상위 POP_SIZE개만 골라(nth_element) 해를 복사하지 않고 옮김
+            maxcut::truncate(population, population_costs, new_population, costs, REPLACEMENT == 1);
+        }
 
-        auto end = chrono::steady_clock::now(); // end: 끝나는 시간
-        if (chrono::duration_cast<chrono::seconds>(end - start).count() > 180) { // 
-            break;
+        // 재시작 판단은 대치 후 살아남은 세대로: (μ+λ), (μ,λ)에서는 후속 세대와 다름
+        maxcut::Diversity diversity(count_V); // 살아남은 세대의 다양성
+        long long generation_best = LLONG_MIN; // 살아남은 세대의 최대 적합도
+        for (size_t i = 0; i < population.size(); ++i) {
+            const vector<int>& survivor = population[i];
+            generation_best = max(generation_best, population_costs[i]);
+            diversity.add([&](size_t j) { return survivor[j] == 1; });
+        }
+        if (restart_policy.update(diversity.normalized(), generation_best)) { // 수렴했으면 재시작
+            restart_population(batch_fitness);
         }
     }
 }
@@ -193,9 +254,12 @@ vector<double> repeated_runs(int runs) {
     vector<double> fitnesses;
     for (int i = 0; i < runs; ++i) { // 30번 반복
         initialize_population();
-        genetic_algorithm();
+        genetic_algorithm(TIME_LIMIT / runs); // 반복 실행마다 같은 시간
         vector<int> best_individual = get_best(); 
         fitnesses.push_back(fitness(best_individual)); // 가장 우수한 해 fitnesses 컨테이너에 삽입
+        if (maxcut::stop_requested()) { // 중단 시그널을 받았으면 남은 반복 생략
+            break;
+        }
     }
     return fitnesses;
 }
@@ -216,8 +280,9 @@ double standard_deviation_fitness(const vector<double>& fitnesses, double averag
 int main(){
 
     string inputFile = "maxcut.in"; // 입력 파일명
-    string outputFile = "maxcut.out"; // 출력 파일명
-    
+    // 출력 파일(maxcut.out)은 incumbent가 관리
+    maxcut::install_stop_handlers(&incumbent); // SIGINT/SIGTERM을 받으면 최선의 해를 쓰고 바로 종료
+
 
     ifstream inFile(inputFile);
     inFile >> count_V >> count_E; // 정점 개수, 간선 개수 읽기
@@ -241,16 +306,9 @@ int main(){
     //initialize_population();
     //genetic_algorithm();
 
-    vector<int> best_individual = get_best(); // 가장 우수한 해
-
-    ofstream outFile(outputFile);
-    for (int i = 0; i < count_V; ++i) {
-        if (best_individual[i] == 1) {
-            outFile << i + 1 << " "; // 처음에 inFile의 정점을 읽을 때 1씩 뺐기 때문에 다시 1씩 더함
-            //cout << i + 1 << " "; // 출력
-        }
-    }
-    outFile.close();
+    vector<int> best_individual = get_best(); // 마지막 실행에서 가장 우수한 해
+    incumbent.offer(fitness(best_individual), count_V, [&](size_t j) { return best_individual[j] == 1; });
+    incumbent.flush(); // 모든 실행을 통틀어 가장 좋은 해를 maxcut.out에 씀
     
 
 
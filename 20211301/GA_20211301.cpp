@@ -5,6 +5,10 @@
 #include <chrono>
 #include <ctime>
 #include <limits>
+#include <algorithm>
+#include "../maxcut/deadline.h" //   ð 
+#include "../maxcut/incumbent.h" // ּ  anytime 
+#include "../maxcut/pair_window.h" // ġ   ϴ θ  
 using namespace std;
 
 
@@ -36,6 +40,16 @@ struct Edge {
 };
 
 
+// , ּ :   ذ   maxcut.out 
+int vertexCount = 0;
+maxcut::Incumbent incumbent("maxcut.out");
+
+//ּ  : ü i° ڰ  i+1
+void offerBest(const string& chromosome, long long Weight) {
+    incumbent.offer(Weight, vertexCount, [&](size_t i) { return i < chromosome.size() && chromosome[i] == '1'; });
+}
+
+
 //׷ б
 vector<Edge> readGraphFromFile(const string& filename) {
     vector<Edge> graph;
@@ -43,6 +57,7 @@ vector<Edge> readGraphFromFile(const string& filename) {
     if (file.is_open()) {
         int numVertices, numEdges;
         file >> numVertices >> numEdges; //ù
+        vertexCount = numVertices;
 
         for (int i = 0; i < numEdges; i++) {
             Edge edge;
@@ -81,8 +96,8 @@ string generateDNA(const vector<Edge>& graph) {
 
 
 //ġ 
-int calculateWeight(const vector<Edge>& graph, const string& chromosome) {
-    int Weight = 0;
+long long calculateWeight(const vector<Edge>& graph, const string& chromosome) {
+    long long Weight = 0; //64Ʈ ջ:  Ƶ ġ 
     for (const auto& edge : graph) {
         if (chromosome[edge.node1 - 1] == '1' && chromosome[edge.node2 - 1] == '0') {
             Weight += edge.weight;
@@ -97,7 +112,17 @@ int calculateWeight(const vector<Edge>& graph, const string& chromosome) {
 
  
 //θǮ 
-vector<pair<string, double>> parentPool;
+vector<pair<string, long long>> parentPool; //ġ  ״ 
+maxcut::PairWindow parentWindow; //θǮ ġ   , ִ ġ 
+
+//θǮ  : θǮ ٲ  ȣ
+void indexParentPool() {
+    vector<long long> weights;
+    for (const auto& gene : parentPool) {
+        weights.push_back(gene.second);
+    }
+    parentWindow.build(weights.data(), weights.size(), 0.5);
+}
 
 void genParentPool(const vector<Edge>& graph) {
     int population=graph.size()*10;
@@ -109,44 +134,27 @@ void genParentPool(const vector<Edge>& graph) {
     for (int i = 1; i <= population; i++) {
         string chromo = generateDNA(graph);
         //ġ ؼ Weight 
-        int Weight = calculateWeight(graph, chromo);
+        long long Weight = calculateWeight(graph, chromo);
         parentPool.emplace_back(chromo, Weight); //θǮ 
+        offerBest(chromo, Weight);
     }
+    indexParentPool();
 }
 
 
 
 // ڿ ġ ϴ  Ÿ 
-using GeneWeightPair_Parent = pair<string, double>;
+using GeneWeightPair_Parent = pair<string, long long>;
 
 // Selection Լ 
+// ġ ̰ θǮ ִ ġ 50%   ڸ 
+//  ̰    ٽ ̴ , ġ  (parentWindow)
+// ̺ Ž    ϴ  ٷ :     ־ 쵵 O(log P)
+mt19937 selectionGen(random_device{}());
+
 pair<GeneWeightPair_Parent, GeneWeightPair_Parent> Selection(const vector<GeneWeightPair_Parent>& parentPool) {
-    random_device rd;
-    mt19937 gen(rd());
-    uniform_int_distribution<> dist(0, parentPool.size() - 1);
-
-    while (true) {
-        // ϰ    
-        int index1 = dist(gen);
-        int index2 = dist(gen);
-
-        const GeneWeightPair_Parent& gene1 = parentPool[index1];
-        const GeneWeightPair_Parent& gene2 = parentPool[index2];
-
-        //   ġ  
-        double weightDiff = abs(gene1.second - gene2.second);
-        
-        // maxDiff θǮ ġ ִ, ּҰ  50%  
-        double maxDiff = (max_element(parentPool.begin(), parentPool.end(),
-            [](const GeneWeightPair_Parent& a, const GeneWeightPair_Parent& b) {
-                return a.second < b.second;
-            })->second) * 0.5;
-
-        if (weightDiff <= maxDiff) {
-            //  ϴ   ڵ ȯ
-            return make_pair(gene1, gene2);
-        }
-    }
+    pair<size_t, size_t> picked = parentWindow.sample(selectionGen);
+    return make_pair(parentPool[picked.first], parentPool[picked.second]);
 }
 
 
@@ -190,17 +198,23 @@ string Crossover(const string& gene1, const string& gene2) {
 
 
 //ڽǮ  Լ
-vector<pair<string, double>> childPool;
-void genchildPool(const vector<Edge>& graph) {
+vector<pair<string, long long>> childPool;
+void genchildPool(const vector<Edge>& graph, maxcut::Deadline& deadline) {
     //: θǮ 
     int parentSize = parentPool.size();
+    indexParentPool(); //θǮ ġ  
     
     for (int i = 1; i <= parentSize; i++) {
+        // ð ޽ ߴ
+        if (deadline.expired()) {
+            return;
+        }
         pair<GeneWeightPair_Parent, GeneWeightPair_Parent> selectedGenes = Selection(parentPool); //selection
         string child = Crossover(selectedGenes.first.first, selectedGenes.second.first); //crossover
         string chromo = child;
-        int Weight = calculateWeight(graph, chromo); //ġ 
+        long long Weight = calculateWeight(graph, chromo); //ġ 
         childPool.emplace_back(chromo, Weight); //ڽǮ pair 
+        offerBest(chromo, Weight);
     }
 }
 
@@ -216,10 +230,10 @@ void replace(vector<int>& parentPool, vector<int>& childPool) {
 
 
 //Ǯ ġ ,  ,  
-void calculateParentPoolStats(const vector<Edge>& graph, const vector<pair<string, double>>& parentPool) {
+void calculateParentPoolStats(const vector<Edge>& graph, const vector<pair<string, long long>>& parentPool) {
     double totalWeight = 0.0; // ġ 
     double maxWeight = numeric_limits<double>::min(); // ִ ġ
-    pair<string, double> maxWeightPair; // ִ ġ  
+    pair<string, long long> maxWeightPair; // ִ ġ  
     double sumSquaredDiff = 0.0; //  
 
     for (const auto& pair : parentPool) {
@@ -249,35 +263,29 @@ void calculateParentPoolStats(const vector<Edge>& graph, const vector<pair<strin
 
 int main() {
 
+    maxcut::install_stop_handlers(&incumbent); //SIGINT/SIGTERM  ּ ظ  ٷ 
     string inputFilename = "unweighted_50.txt";  // ش  б
     vector<Edge> graph = readGraphFromFile(inputFilename);
     genParentPool(graph);  //ʱ θǮ 
 
-    // ð 
+    // ð :  ð 
     int seconds = 10;
-    chrono::time_point<chrono::system_clock> startTime = chrono::system_clock::now();
+    maxcut::Deadline deadline(seconds);
     parentPool = parentPool;
     childPool = childPool;
 
 
     // ð 
-    while (true) {
-        chrono::time_point<chrono::system_clock> currentTime = chrono::system_clock::now();
-        chrono::duration<double> elapsedSeconds = currentTime - startTime;
-
-        // ð ޽ 
-        if (elapsedSeconds.count() >= seconds) {
-            break;
-        }
-
+    while (!deadline.expired()) {
         //뱳ü ݺ 
         while (true) {
-            genchildPool(graph); // , , ݺ  ڽǮ 
+            genchildPool(graph, deadline); // , , ݺ  ڽǮ 
             //replace(parentPool, childPool); //  ü
             break;
         }   
     }
     
     calculateParentPoolStats(graph, parentPool);
+    incumbent.flush();
     return 0;
 }
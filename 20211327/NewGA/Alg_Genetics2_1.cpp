@@ -6,9 +6,18 @@
 #include <fstream>
 #include <numeric>
 #include <algorithm>
+#include "../../maxcut/deadline.h" // Shared time limit service
+#include "../../maxcut/incumbent.h" // Best-so-far solution, rewritten to maxcut.out on every improvement
 
 using namespace std;
 vector <pair<int, int>> adj[10001];
+maxcut::Incumbent incumbent("maxcut.out");
+
+//Offer a chromosome to the incumbent: vertex i+1 is on side Chrom[i]
+void OfferBest(const vector<int>& Chrom, int cost)
+{
+    incumbent.offer(cost, Chrom.size(), [&](size_t i) { return Chrom[i] == 1; });
+}
 
 //Make Graph
 void set_vertice(int _s, int _a, int w)
@@ -257,6 +266,8 @@ void printBestSolution(const std::vector<int>& cost, const std::vector<std::vect
 
 int main()
 {
+    maxcut::install_stop_handlers(&incumbent); //On SIGINT/SIGTERM, write the best solution and exit at once
+    maxcut::Deadline deadline(180); //Time limit (seconds)
     srand(time(NULL));
     //Make adjacent List
     ifstream inputfile("unweighted_50.txt");
@@ -285,6 +296,7 @@ int main()
     for (int i = 0; i < sol.size(); i++) {
         vector<int> a = sol[i];
         Cost.push_back(CutSize(a));
+        OfferBest(a, Cost.back());
     }
     int cw = *min_element(Cost.begin(), Cost.end());
     int cb = *max_element(Cost.begin(), Cost.end());
@@ -312,7 +324,7 @@ int main()
     vector<vector<int>> sol_ = sol;
     vector<int>Cost_ = Cost;
     vector<int> Fit_ = Fit;
-    while (t > 0)
+    while (t > 0 && !deadline.expired())
     {
         int p1, p2;
         p1 = Roulette(sortedFit_, Ft_sum_);
@@ -345,6 +357,7 @@ int main()
             //Cost update
             Cost_.erase(Cost_.begin() + ReplaceRes);
             Cost_.insert(Cost_.begin() + ReplaceRes, CutSize(Offspring));
+            OfferBest(Offspring, Cost_[ReplaceRes]);
             //New Generation Chromosome
             std::vector <int> ReplChrom = sol_[ReplaceRes];
             sol_[ReplaceRes] = Offspring;
@@ -396,6 +409,7 @@ int main()
     for (int r = 0; r < Set.size(); r++) {
         cout << Set[r] << " ";
     }
+    incumbent.flush();
 
 
 }
\ No newline at end of file
@@ -4,34 +4,50 @@
 #include <algorithm>
 #include <cstdlib>
 #include <ctime>
-#include <set>
 #include <numeric>
 #include <chrono>
 #include <cmath>
+#include <climits>
+#include <random>
+#include "../maxcut/deadline.h"
+#include "../maxcut/incumbent.h"
+#include "../maxcut/diversity.h"
+#include "../maxcut/sliced.h"
+#include "../maxcut/tournament.h"
 using namespace std;
 
 #define POP_SIZE 200  
-#define GENERATIONS 1000
 #define MUTATION_RATE 0.01
 #define TOURNAMENT_SIZE 2
 #define CROSSOVER_RATE 0.7
+#define TIME_LIMIT 180.0 // seconds, shared by all runs
 
 struct Edge {
     int u, v, weight;
 };
 
 vector<vector<int>> population;
+vector<long long> population_costs; // fitness of population[i], cached for selection
 vector<Edge> edges;
 int V, E;
+maxcut::Incumbent incumbent("maxcut.txt"); // best cut over all runs, rewritten on every improvement
+maxcut::TournamentBatch tournaments;
+mt19937_64 rng;
+
+vector<int> random_individual() {
+    vector<int> individual;
+    for (int j = 0; j < V; ++j) {
+        individual.push_back(rand() % 2);
+    }
+    return individual;
+}
 
 void initialize_population() {
     srand(time(NULL));
+    rng.seed(time(NULL));
+    population.clear();
     for (int i = 0; i < POP_SIZE; ++i) {
-        vector<int> individual;
-        for (int j = 0; j < V; ++j) {
-            individual.push_back(rand() % 2);
-        }
-        population.push_back(individual);
+        population.push_back(random_individual());
     }
 }
 
@@ -45,33 +61,18 @@ int fitness(const vector<int>& individual) {
     return fitness;
 }
 
-vector<int> tournament_selection() {
-    set<int> chosen;
-    while (chosen.size() < TOURNAMENT_SIZE) {
-        chosen.insert(rand() % POP_SIZE);
-    }
-
-    int number = rand() % 10;
-    int best = *chosen.begin();
-    for (const auto& idx : chosen) {
-        if (fitness(population[idx]) > fitness(population[best])) {
-            best = idx;
+// all 2 * POP_SIZE tournaments of a generation at once, over the cached costs; returns the winners' indices
+vector<size_t> tournament_selection() {
+    vector<size_t> best(2 * POP_SIZE), worse(2 * POP_SIZE);
+    tournaments.run(population_costs.data(), population.size(), TOURNAMENT_SIZE, 2 * POP_SIZE, rng,
+        best.data(), worse.data());
+    for (size_t t = 0; t < best.size(); ++t) {
+        int number = rand() % 10;
+        if (number >= 7) {
+            best[t] = worse[t];
         }
     }
-
-    int worse = *chosen.begin();
-    for (const auto& idx : chosen) {
-        if (fitness(population[idx]) < fitness(population[worse])) {
-            worse = idx;
-        }
-    }
-
-    if (number < 7) {
-        return population[best];
-    }
-    else {
-        return population[worse];
-    }
+    return best;
 }
 
 void crossover(vector<int>& parent1, vector<int>& parent2) {
@@ -89,22 +90,78 @@ void mutate(vector<int>& individual) {
     }
 }
 
-void genetic_algorithm() {
-    auto start = chrono::steady_clock::now();
-    for (int gen = 0; gen < GENERATIONS; ++gen) {
+// keep the elites of a converged population and re-seed the rest; the elites keep their cached costs,
+// so only the new individuals are scored, as one batch
+void restart_population(maxcut::SlicedCut& batch_fitness) {
+    vector<int> order(population.size());
+    iota(order.begin(), order.end(), 0);
+    size_t n_elites = min(maxcut::RestartPolicy::elite_count(POP_SIZE), order.size());
+    partial_sort(order.begin(), order.begin() + n_elites, order.end(),
+        [&](int a, int b) { return population_costs[a] > population_costs[b]; });
+
+    vector<vector<int>> next_population;
+    vector<long long> next_costs;
+    for (size_t i = 0; i < n_elites; ++i) {
+        next_population.push_back(population[order[i]]);
+        next_costs.push_back(population_costs[order[i]]);
+    }
+    while (next_population.size() < POP_SIZE) {
+        next_population.push_back(random_individual());
+    }
+    next_costs.resize(next_population.size());
+    batch_fitness.evaluate(next_population.size() - n_elites,
+        [&](size_t j, size_t v) { return next_population[n_elites + j][v] == 1; }, next_costs.data() + n_elites);
+    population = next_population;
+    population_costs = next_costs;
+}
+
+void genetic_algorithm(double seconds) {
+    maxcut::Deadline deadline(seconds);
+    maxcut::RestartPolicy restart_policy;
+    vector<maxcut::Edge> cut_edges;
+    for (const auto& edge : edges) {
+        cut_edges.push_back({ edge.u, edge.v, edge.weight });
+    }
+    maxcut::SlicedCut batch_fitness(V, cut_edges); // scores a whole generation per pass over the edges
+    auto evaluate_population = [&]() {
+        population_costs.resize(population.size());
+        batch_fitness.evaluate(population.size(),
+            [&](size_t j, size_t v) { return population[j][v] == 1; }, population_costs.data());
+    };
+    evaluate_population();
+    while (!deadline.expired()) {
         vector<vector<int>> new_population;
+        vector<size_t> parents = tournament_selection();
+        maxcut::Diversity diversity(V);
+        long long generation_best = LLONG_MIN;
+        bool is_over = false;
         for (int i = 0; i < POP_SIZE; ++i) {
-            vector<int> parent1 = tournament_selection();
-            vector<int> parent2 = tournament_selection();
+            if (deadline.expired()) {
+                is_over = true;
+                break;
+            }
+            vector<int> parent1 = population[parents[2 * i]];
+            vector<int> parent2 = population[parents[2 * i + 1]];
             crossover(parent1, parent2);
             mutate(parent1);
             new_population.push_back(parent1);
         }
+        vector<long long> costs(new_population.size());
+        batch_fitness.evaluate(new_population.size(),
+            [&](size_t j, size_t v) { return new_population[j][v] == 1; }, costs.data());
+        for (size_t i = 0; i < new_population.size(); ++i) {
+            const vector<int>& child = new_population[i];
+            incumbent.offer(costs[i], V, [&](size_t j) { return child[j] == 1; });
+            generation_best = max(generation_best, costs[i]);
+            diversity.add([&](size_t j) { return child[j] == 1; });
+        }
+        if (is_over) {
+            break; // keep the last complete generation
+        }
         population = new_population;
-
-        auto end = chrono::steady_clock::now();
-        if (chrono::duration_cast<chrono::seconds>(end - start).count() > 180) {
-            break;
+        population_costs = costs;
+        if (restart_policy.update(diversity.normalized(), generation_best)) {
+            restart_population(batch_fitness);
         }
     }
 }
@@ -123,9 +180,12 @@ vector<double> repeated_runs(int runs) {
     vector<double> fitnesses;
     for (int i = 0; i < runs; ++i) {
         initialize_population();
-        genetic_algorithm();
+        genetic_algorithm(TIME_LIMIT / runs);
         vector<int> best_individual = get_best();
         fitnesses.push_back(fitness(best_individual));
+        if (maxcut::stop_requested()) {
+            break;
+        }
     }
     return fitnesses;
 }
@@ -143,6 +203,7 @@ double standard_deviation_fitness(const vector<double>& fitnesses, double averag
 }
 
 int main() {
+    maxcut::install_stop_handlers(&incumbent);
     ifstream infile("graph.txt");
     infile >> V >> E;
     for (int i = 0; i < E; i++) {
@@ -162,12 +223,7 @@ int main() {
     cout << "Standard Deviation of Fitness: " << std_dev << endl;
 
     vector<int> best_individual = get_best();
-    ofstream outfile("maxcut.txt");
-    for (int i = 0; i < V; i++) {
-        if (best_individual[i] == 1) {
-            outfile << i + 1 << " ";
-        }
-    }
-    outfile.close();
+    incumbent.offer(fitness(best_individual), V, [&](size_t j) { return best_individual[j] == 1; });
+    incumbent.flush();
     return 0;
 }
\ No newline at end of file
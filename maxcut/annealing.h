@@ -0,0 +1,176 @@
+#pragma once
+// Simulated annealing over single-vertex flips
+// Each chain keeps a FlipState, so a move costs O(1) to score and O(deg) to apply. The temperature follows a
+// geometric schedule in elapsed time rather than in moves, T = t_start * (t_end / t_start)^(elapsed / budget),
+// so the chain cools completely by the deadline however fast the moves run. Independent chains run on
+// separate threads and share the incumbent; the engine reports the best of them.
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+#include "deadline.h"
+#include "flip_state.h"
+#include "genome.h"
+#include "graph.h"
+#include "incumbent.h"
+
+namespace maxcut {
+
+struct AnnealConfig {
+	std::uint64_t seed = 0; // random seed, 0 for std::random_device
+	unsigned chains = 0; // independent chains (one thread each), 0 for one per hardware thread
+	double t_start = 0; // initial temperature, 0: an average uphill move is accepted with probability 1/2
+	double t_end = 0; // final temperature, 0: the lightest edge is accepted with probability 1/1000
+	std::size_t block = 1024; // moves between temperature updates (and deadline checks)
+};
+
+class AnnealingEngine {
+private:
+	const Graph* graph;
+	AnnealConfig config;
+	Rng rng;
+	Incumbent* incumbent = nullptr; // anytime output
+	std::vector<std::uint8_t> best; // best partition found
+	long long best_cost = LLONG_MIN;
+	std::size_t moves = 0; // attempted moves over all chains
+
+public:
+	explicit AnnealingEngine(const Graph& graph, AnnealConfig config = AnnealConfig()) : graph(&graph), config(config) {
+		this->config.block = std::max<std::size_t>(this->config.block, 1);
+		rng.seed(config.seed != 0 ? config.seed : (std::uint64_t(std::random_device{}()) << 32) ^ std::random_device{}());
+	}
+
+	// Report every chain's improvements to this incumbent
+	void set_incumbent(Incumbent* incumbent) { this->incumbent = incumbent; }
+
+	// Anneal until the deadline; returns the best cost found (LLONG_MIN if nothing ran)
+	long long run(Deadline& deadline) {
+		std::size_t n = std::size_t(graph->size());
+		if (n == 0 || deadline.expired())
+			return best_cost;
+		unsigned chains = config.chains ? config.chains : std::max(1u, std::thread::hardware_concurrency());
+		double t_start = config.t_start > 0 ? config.t_start : start_temperature();
+		double t_end = config.t_end > 0 ? config.t_end : end_temperature();
+		t_end = std::min(t_end, t_start);
+
+		std::vector<std::uint64_t> seeds(chains);
+		for (auto& s : seeds)
+			s = rng();
+		std::vector<std::vector<std::uint8_t>> results(chains);
+		std::vector<long long> costs(chains, LLONG_MIN);
+		std::vector<std::size_t> counts(chains, 0);
+		// each chain gets its own Deadline (the stride counters are not shared) with the same end
+		double seconds = deadline.remaining();
+		Deadline::clock::time_point start = Deadline::clock::now();
+		auto work = [&](unsigned c) {
+			Deadline local(start, seconds);
+			costs[c] = chain(local, seeds[c], t_start, t_end, results[c], counts[c]);
+		};
+		std::vector<std::thread> pool;
+		for (unsigned c = 1; c < chains; c++)
+			pool.emplace_back(work, c);
+		work(0);
+		for (auto& th : pool)
+			th.join();
+
+		for (unsigned c = 0; c < chains; c++) {
+			moves += counts[c];
+			if (costs[c] > best_cost) {
+				best_cost = costs[c];
+				best = std::move(results[c]);
+			}
+		}
+		return best_cost;
+	}
+
+	// Best partition as 0 / 1 per vertex
+	const std::vector<std::uint8_t>& best_genome() const { return best; }
+	long long best_value() const { return best_cost; }
+	// Sweeps (n attempted moves) over all chains, reported where the GA engines report generations
+	std::size_t generation_count() const { return graph->size() > 0 ? moves / std::size_t(graph->size()) : 0; }
+	int restart_count() const { return 0; }
+
+private:
+	// One chain from a random partition; the best partition goes to out, attempted moves to count
+	long long chain(Deadline& deadline, std::uint64_t seed, double t_start, double t_end,
+		std::vector<std::uint8_t>& out, std::size_t& count) {
+		Rng local(seed);
+		std::size_t n = std::size_t(graph->size());
+		FlipState state(*graph);
+		state.assign([&](std::size_t) { return (local() >> 63) != 0; });
+		out = state.partition();
+		long long best_cut = state.cut();
+		offer(out, best_cut);
+
+		double budget = std::max(deadline.budget(), 1e-9);
+		double log_ratio = std::log(t_end / t_start);
+		double temperature = t_start;
+		auto random_unit = [&]() { return double(local() >> 11) * (1.0 / 9007199254740992.0); }; // [0, 1)
+		while (!deadline.check()) {
+			double inv_t = 1.0 / temperature;
+			for (std::size_t i = 0; i < config.block; i++) {
+				int v = int((std::uint64_t(std::uint32_t(local())) * n) >> 32);
+				long long delta = state.gain(v);
+				// exp(-x) < 2^-53 for x > 37: such a move is never accepted, skip the exp
+				if (delta >= 0 || (double(-delta) * inv_t < 37.0 && random_unit() < std::exp(double(delta) * inv_t)))
+					state.flip(v);
+			}
+			count += config.block;
+			// the best state is sampled once per block: copying it after every improving move would cost O(n)
+			if (state.cut() > best_cut) {
+				best_cut = state.cut();
+				out = state.partition();
+				offer(out, best_cut);
+			}
+			temperature = t_start * std::exp(log_ratio * std::min(1.0, deadline.elapsed() / budget));
+		}
+		// quench: the final state (or the best one) to a local optimum
+		if (state.cut() < best_cut)
+			state.assign([&](std::size_t v) { return out[v] != 0; });
+		state.descend();
+		if (state.cut() > best_cut) {
+			best_cut = state.cut();
+			out = state.partition();
+			offer(out, best_cut);
+		}
+		return best_cut;
+	}
+
+	void offer(const std::vector<std::uint8_t>& sides, long long cost) {
+		if (incumbent != nullptr)
+			incumbent->offer(cost, sides.size(), [&](std::size_t i) { return sides[i] == sides[0]; });
+	}
+
+	// Mean weight lost by uphill flips from a random partition, as a temperature accepting them half the time
+	double start_temperature() {
+		FlipState state(*graph);
+		state.assign([&](std::size_t) { return (rng() >> 63) != 0; });
+		double sum = 0;
+		std::size_t uphill = 0;
+		for (std::size_t v = 0; v < state.size(); v++) {
+			if (state.gain(int(v)) < 0) {
+				sum -= double(state.gain(int(v)));
+				uphill++;
+			}
+		}
+		double mean = uphill ? sum / double(uphill) : 1.0;
+		return mean / std::log(2.0);
+	}
+
+	// Temperature at which losing the lightest edge is accepted with probability 1/1000
+	double end_temperature() const {
+		long long lightest = LLONG_MAX;
+		for (const Edge& e : graph->edges) {
+			if (e.w != 0)
+				lightest = std::min(lightest, std::llabs((long long)e.w));
+		}
+		return double(lightest == LLONG_MAX ? 1 : lightest) / std::log(1000.0);
+	}
+};
+
+} // namespace maxcut
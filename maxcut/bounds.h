@@ -0,0 +1,155 @@
+#pragma once
+// Upper bounds on the maximum cut, and the bipartite shortcut
+// With signed weights no cut beats `positive`, the sum of the positive weights: it needs every positive edge
+// cut and every negative edge uncut. (Summing each vertex's positive incident weight and halving gives the
+// same number, since every edge is counted from both ends.) Call an edge satisfied when it is as that bound
+// wants; a cut then weighs positive minus the |w| of its unsatisfied edges.
+// A BFS forest fixes the parity of every vertex so that its tree edges are satisfied. If every other edge is
+// satisfied too, the graph is balanced (bipartite, for positive weights) and the parities are an optimal
+// partition, found in O(V + E). Otherwise each unsatisfied non-tree edge closes a frustrated cycle (an odd
+// cycle, for positive weights) on which no partition satisfies every edge, so any cut leaves at least the
+// cycle's smallest |w| behind, and losses on edge-disjoint cycles add up. Cycles of up to max_cycle edges are
+// packed greedily, shortest first (a long cycle forfeits a single weight and blocks many others); the edges
+// taken are removed and the search repeated on the rest, within a step budget linear in the graph size.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "graph.h"
+
+namespace maxcut {
+
+struct CutBounds {
+	long long positive = 0; // sum of the positive weights
+	long long cycle_loss = 0; // weight the packed frustrated cycles must leave uncut
+	std::size_t cycles = 0; // frustrated cycles packed
+	bool balanced = false; // true when positive is attained (the graph is bipartite for positive weights)
+
+	// No cut of the graph weighs more
+	long long upper() const { return positive - cycle_loss; }
+};
+
+// Bound the maximum cut of graph; when it is balanced, sides gets an optimal partition (0 / 1 per vertex)
+inline CutBounds cut_bounds(const Graph& graph, std::vector<std::uint8_t>& sides, int max_cycle = 32) {
+	CutBounds bounds;
+	std::size_t n = std::size_t(graph.size()), m = graph.edge_count();
+	for (const Edge& e : graph.edges)
+		bounds.positive += e.w > 0 ? e.w : 0;
+
+	// edge ids around every vertex, in the CSR layout
+	std::vector<int> incident(2 * m);
+	std::vector<int> pos(graph.offset.begin(), graph.offset.end() - 1);
+	for (std::size_t i = 0; i < m; i++) {
+		incident[std::size_t(pos[graph.edges[i].u]++)] = int(i);
+		incident[std::size_t(pos[graph.edges[i].v]++)] = int(i);
+	}
+	auto magnitude = [&](int i) { return graph.edges[i].w < 0 ? -(long long)graph.edges[i].w : (long long)graph.edges[i].w; };
+
+	std::vector<std::uint8_t> removed(m, 0); // zero-weight edges and the edges of packed cycles
+	for (std::size_t i = 0; i < m; i++)
+		removed[i] = graph.edges[i].w == 0;
+	std::vector<std::uint8_t> parity(n), seen(n), taken(m);
+	std::vector<int> up_edge(n), depth(n), queue;
+	std::vector<std::pair<int, int>> candidates; // (tree path length, closing edge)
+	queue.reserve(n);
+	std::size_t budget = 2 * (n + m) + (std::size_t(1) << 20); // vertex, edge and tree path visits left
+	for (bool first = true;; first = false) {
+		// BFS forest over the edges left: parity makes every tree edge satisfied
+		std::fill(seen.begin(), seen.end(), 0);
+		std::fill(up_edge.begin(), up_edge.end(), -1);
+		queue.clear();
+		for (std::size_t root = 0; root < n; root++) {
+			if (seen[root])
+				continue;
+			seen[root] = 1;
+			parity[root] = 0;
+			depth[root] = 0;
+			queue.push_back(int(root));
+			for (std::size_t head = queue.size() - 1; head < queue.size(); head++) {
+				int v = queue[head];
+				for (int k = graph.offset[v]; k < graph.offset[v + 1]; k++) {
+					int i = incident[std::size_t(k)];
+					const Edge& e = graph.edges[std::size_t(i)];
+					int u = e.u == v ? e.v : e.u;
+					if (seen[u] || removed[i])
+						continue;
+					seen[u] = 1;
+					parity[u] = std::uint8_t(parity[v] ^ (e.w > 0));
+					depth[u] = depth[v] + 1;
+					up_edge[u] = i;
+					queue.push_back(u);
+				}
+			}
+		}
+		budget -= std::min(budget, n + 2 * m);
+
+		// the unsatisfied edges, by the length of the cycle they close
+		candidates.clear();
+		std::size_t unsatisfied = 0;
+		for (std::size_t i = 0; i < m; i++) {
+			const Edge& e = graph.edges[i];
+			if (!removed[i] && (parity[e.u] ^ parity[e.v]) != (e.w > 0)) {
+				unsatisfied++;
+				int a = e.u, b = e.v, length = 1;
+				while (a != b && length < max_cycle && budget > 0) {
+					int& deeper = depth[a] >= depth[b] ? a : b;
+					const Edge& t = graph.edges[std::size_t(up_edge[deeper])];
+					deeper = t.u == deeper ? t.v : t.u;
+					length++;
+					budget--;
+				}
+				if (a == b)
+					candidates.push_back({ length, int(i) });
+			}
+		}
+		if (first) {
+			bounds.balanced = unsatisfied == 0;
+			if (bounds.balanced) {
+				sides.assign(parity.begin(), parity.end());
+				return bounds;
+			}
+		}
+		if (candidates.empty())
+			break;
+		std::sort(candidates.begin(), candidates.end());
+
+		// take the cycles whose edges are all still free
+		std::fill(taken.begin(), taken.end(), 0);
+		std::size_t packed = 0;
+		for (const auto& c : candidates) {
+			const Edge& closing = graph.edges[std::size_t(c.second)];
+			long long least = magnitude(c.second);
+			bool free = true;
+			for (int a = closing.u, b = closing.v; a != b && free;) {
+				int& deeper = depth[a] >= depth[b] ? a : b;
+				int i = up_edge[deeper];
+				free = !taken[i];
+				budget -= std::min<std::size_t>(budget, 1);
+				least = std::min(least, magnitude(i));
+				const Edge& t = graph.edges[std::size_t(i)];
+				deeper = t.u == deeper ? t.v : t.u;
+			}
+			if (!free)
+				continue;
+			taken[std::size_t(c.second)] = 1;
+			for (int a = closing.u, b = closing.v; a != b;) {
+				int& deeper = depth[a] >= depth[b] ? a : b;
+				int i = up_edge[deeper];
+				taken[i] = 1;
+				const Edge& t = graph.edges[std::size_t(i)];
+				deeper = t.u == deeper ? t.v : t.u;
+			}
+			bounds.cycle_loss += least;
+			packed++;
+		}
+		bounds.cycles += packed;
+		for (std::size_t i = 0; i < m; i++)
+			removed[i] |= taken[i];
+		if (packed == 0 || budget == 0)
+			break;
+	}
+	return bounds;
+}
+
+} // namespace maxcut
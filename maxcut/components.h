@@ -0,0 +1,218 @@
+#pragma once
+// Connected-component decomposition
+// The cut weight is the sum of the components' cuts and each component's sides can be chosen on their own,
+// so components are solved as separate, smaller graphs. Components are found with union-find over the edge
+// list; isolated vertices are left out (their side does not matter) and so are two-vertex components, which
+// are solved on the spot. ComponentEngine starts every larger component from a single-flip local optimum,
+// then hands it to a solver (any variant, see variants.h) on a pool of threads, largest first, with a share
+// of the time proportional to its size, and stitches each finished component into the full partition (and
+// the incumbent) right away.
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <numeric>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "deadline.h"
+#include "flip_state.h"
+#include "graph.h"
+#include "incumbent.h"
+
+namespace maxcut {
+
+// Disjoint sets with union by size and path halving
+class UnionFind {
+private:
+	std::vector<int> up; // parent, or -(set size) at a root
+
+public:
+	explicit UnionFind(std::size_t n = 0) : up(n, -1) {}
+
+	int find(int v) {
+		while (up[v] >= 0) {
+			if (up[up[v]] >= 0)
+				up[v] = up[up[v]];
+			v = up[v];
+		}
+		return v;
+	}
+
+	// Merge the sets of a and b; false when they were already one set
+	bool unite(int a, int b) {
+		a = find(a);
+		b = find(b);
+		if (a == b)
+			return false;
+		if (up[a] > up[b])
+			std::swap(a, b);
+		up[a] += up[b];
+		up[b] = a;
+		return true;
+	}
+
+	int set_size(int v) { return -up[find(v)]; }
+};
+
+struct Component {
+	Graph graph; // the component, vertices renumbered 0 .. k-1
+	std::vector<int> vertices; // original vertex of each component vertex
+};
+
+// Split graph into its components with at least two vertices, largest (vertices + edges) first
+inline std::vector<Component> split_components(const Graph& graph) {
+	std::size_t n = std::size_t(graph.size());
+	UnionFind sets(n);
+	for (const Edge& e : graph.edges)
+		sets.unite(e.u, e.v);
+
+	std::vector<int> index(n, -1); // component of each root, then local number of each vertex
+	std::vector<Component> components;
+	std::vector<int> local(n, -1);
+	for (std::size_t v = 0; v < n; v++) {
+		int r = sets.find(int(v));
+		if (sets.set_size(r) < 2)
+			continue;
+		if (index[r] < 0) {
+			index[r] = int(components.size());
+			components.emplace_back();
+		}
+		Component& c = components[std::size_t(index[r])];
+		local[v] = int(c.vertices.size());
+		c.vertices.push_back(int(v));
+	}
+	std::vector<std::vector<Edge>> edges(components.size());
+	for (const Edge& e : graph.edges)
+		edges[std::size_t(index[sets.find(e.u)])].push_back(Edge{ local[e.u], local[e.v], e.w });
+	for (std::size_t c = 0; c < components.size(); c++)
+		components[c].graph = Graph(int(components[c].vertices.size()), std::move(edges[c]));
+
+	std::stable_sort(components.begin(), components.end(), [](const Component& a, const Component& b) {
+		return a.graph.size() + a.graph.edge_count() > b.graph.size() + b.graph.edge_count();
+	});
+	return components;
+}
+
+// Solve is called as long long solve(const Graph& component, Deadline&, std::vector<std::uint8_t>& sides)
+// from several threads at once, and returns the component's cut with its partition in sides (LLONG_MIN for none)
+template <class Solve>
+class ComponentEngine {
+private:
+	const Graph* graph;
+	Solve solve;
+	unsigned threads; // solver threads, 0 for one per hardware thread
+	Incumbent* incumbent = nullptr; // anytime output
+	std::mutex lock; // guards the fields below while components finish
+	std::vector<std::uint8_t> best; // stitched partition
+	std::vector<long long> cuts; // best cut of each component so far
+	long long best_cost = LLONG_MIN;
+	std::size_t solved = 0; // components handed to the solver
+	std::size_t component_total = 0; // components with two or more vertices
+
+public:
+	explicit ComponentEngine(const Graph& graph, Solve solve, unsigned threads = 0)
+		: graph(&graph), solve(solve), threads(threads) {}
+
+	// Report every improvement of the stitched partition to this incumbent
+	void set_incumbent(Incumbent* incumbent) { this->incumbent = incumbent; }
+
+	long long run(Deadline& deadline) {
+		std::vector<Component> components = split_components(*graph);
+		component_total = components.size();
+		best.assign(std::size_t(graph->size()), 0);
+		cuts.assign(components.size(), 0);
+		best_cost = 0;
+
+		std::vector<std::size_t> pending;
+		double total_size = 0;
+		for (std::size_t c = 0; c < components.size(); c++) {
+			const Component& comp = components[c];
+			if (comp.vertices.size() > 2) {
+				// a local optimum to stand in until the solver is done
+				FlipState state(comp.graph);
+				state.assign([](std::size_t) { return false; });
+				state.descend();
+				for (std::size_t k = 0; k < comp.vertices.size(); k++)
+					best[std::size_t(comp.vertices[k])] = state.partition()[k];
+				cuts[c] = state.cut();
+				best_cost += cuts[c];
+				pending.push_back(c);
+				total_size += double(comp.graph.size() + comp.graph.edge_count());
+				continue;
+			}
+			// two vertices: cut their (merged) edge if it is positive
+			long long w = comp.graph.total_weight();
+			best[std::size_t(comp.vertices[1])] = w > 0;
+			cuts[c] = std::max(w, 0LL);
+			best_cost += cuts[c];
+		}
+		publish();
+
+		// largest first; a component gets the time left * threads * (its size / size not yet started), so time a
+		// solver leaves unused goes to the later components, and never runs past the deadline
+		unsigned workers = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+		workers = unsigned(std::min<std::size_t>(workers, std::max<std::size_t>(pending.size(), 1)));
+		Deadline::clock::time_point end = Deadline::clock::now()
+			+ std::chrono::duration_cast<Deadline::clock::duration>(std::chrono::duration<double>(deadline.remaining()));
+		std::size_t next = 0;
+		double unstarted = total_size;
+		auto work = [&]() {
+			std::vector<std::uint8_t> sides;
+			while (true) {
+				std::size_t c;
+				double share;
+				{
+					std::lock_guard<std::mutex> guard(lock);
+					if (next >= pending.size() || stop_requested())
+						return;
+					c = pending[next++];
+					solved++;
+					double size = double(components[c].graph.size() + components[c].graph.edge_count());
+					share = std::min(1.0, double(workers) * size / std::max(unstarted, 1.0));
+					unstarted -= size;
+				}
+				const Component& comp = components[c];
+				Deadline::clock::time_point now = Deadline::clock::now();
+				double left = std::chrono::duration<double>(end - now).count();
+				Deadline local(now, std::max(0.0, left * share));
+				long long cost = solve(comp.graph, local, sides);
+				if (cost == LLONG_MIN || sides.size() != comp.vertices.size())
+					continue;
+				std::lock_guard<std::mutex> guard(lock);
+				if (cost <= cuts[c])
+					continue;
+				for (std::size_t k = 0; k < sides.size(); k++)
+					best[std::size_t(comp.vertices[k])] = sides[k];
+				best_cost += cost - cuts[c];
+				cuts[c] = cost;
+				publish();
+			}
+		};
+		std::vector<std::thread> pool;
+		for (unsigned t = 1; t < workers; t++)
+			pool.emplace_back(work);
+		work();
+		for (auto& th : pool)
+			th.join();
+		return best_cost;
+	}
+
+	const std::vector<std::uint8_t>& best_genome() const { return best; }
+	long long best_value() const { return best_cost; }
+	// Components handed to the solver, reported where the GA engines report generations
+	std::size_t generation_count() const { return solved; }
+	int restart_count() const { return 0; }
+	std::size_t component_count() const { return component_total; }
+
+private:
+	// Offer the stitched partition; the caller holds lock (or no solver thread is running yet)
+	void publish() {
+		if (incumbent != nullptr && !best.empty())
+			incumbent->offer(best_cost, best.size(), [&](std::size_t i) { return best[i] == best[0]; });
+	}
+};
+
+} // namespace maxcut
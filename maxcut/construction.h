@@ -0,0 +1,112 @@
+#pragma once
+// Randomized greedy (GRASP) construction of initial genomes
+// Vertices are placed one at a time. For every unplaced vertex the running sums to0 / to1 hold the weight of its
+// edges to vertices already on side 0 / 1, so placing it on the side opposite the larger sum adds max(to0, to1)
+// to the cut. Each step takes a window of unplaced vertices, keeps those whose gain is within alpha of the
+// window's best (the restricted candidate list), places a random one of them greedily and updates its
+// neighbours' sums over the CSR arrays: O(n * window + E) per genome.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <thread>
+#include <vector>
+#include "genome.h"
+#include "graph.h"
+
+namespace maxcut {
+
+class GreedyConstruction {
+private:
+	const Graph* graph;
+	double alpha; // 0: pure greedy, 1: any vertex of the window
+	std::size_t window; // unplaced vertices examined per step
+	std::vector<long long> to0, to1; // weight to the vertices placed on side 0 / 1
+	std::vector<int> unplaced; // in random order; placed vertices are swapped out
+
+public:
+	explicit GreedyConstruction(const Graph& graph, double alpha = 0.3, std::size_t window = 64)
+		: graph(&graph), alpha(alpha), window(std::max<std::size_t>(window, 1)) {}
+
+	// Overwrite g (already sized to the vertex count) with a randomized greedy partition
+	template <class Genome>
+	void operator()(Genome& g, Rng& rng) {
+		std::size_t n = std::size_t(graph->size());
+		to0.assign(n, 0);
+		to1.assign(n, 0);
+		unplaced.resize(n);
+		for (std::size_t i = 0; i < n; i++)
+			unplaced[i] = int(i);
+		std::shuffle(unplaced.begin(), unplaced.end(), rng);
+
+		while (!unplaced.empty()) {
+			std::size_t left = unplaced.size(), count = std::min(window, left);
+			std::size_t start = (count < left) ? std::uniform_int_distribution<std::size_t>(0, left - 1)(rng) : 0;
+			auto at = [&](std::size_t k) { return start + k < left ? start + k : start + k - left; }; // cyclic window
+			auto gain = [&](int v) { return std::max(to0[v], to1[v]); };
+
+			long long best = gain(unplaced[at(0)]), worst = best;
+			for (std::size_t k = 1; k < count; k++) {
+				long long x = gain(unplaced[at(k)]);
+				best = std::max(best, x);
+				worst = std::min(worst, x);
+			}
+			// restricted candidate list: count it, then take its r-th member
+			double threshold = double(best) - alpha * double(best - worst);
+			std::size_t listed = 0;
+			for (std::size_t k = 0; k < count; k++)
+				listed += double(gain(unplaced[at(k)])) >= threshold;
+			std::size_t r = std::uniform_int_distribution<std::size_t>(0, listed - 1)(rng), pick = at(0);
+			for (std::size_t k = 0; k < count; k++) {
+				if (double(gain(unplaced[at(k)])) >= threshold && r-- == 0) {
+					pick = at(k);
+					break;
+				}
+			}
+
+			int v = unplaced[pick];
+			unplaced[pick] = unplaced.back();
+			unplaced.pop_back();
+			bool side = (to0[v] != to1[v]) ? (to0[v] > to1[v]) : bool(rng() & 1);
+			g.set(std::size_t(v), side);
+			std::vector<long long>& to = side ? to1 : to0;
+			for (int k = graph->offset[v]; k < graph->offset[v + 1]; k++)
+				to[graph->adj[k]] += graph->adj_w[k];
+		}
+	}
+};
+
+// Fill genomes[0 .. count) with partitions of graph: the first n_greedy by GreedyConstruction, the rest uniformly
+// random. Work is split over `threads` threads (0: one per hardware thread), each with its own generator seeded
+// from rng, so the result depends only on rng and the thread count.
+template <class Genome>
+void construct_genomes(const Graph& graph, Genome* genomes, std::size_t count, std::size_t n_greedy, double alpha,
+	Rng& rng, unsigned threads = 0) {
+	std::size_t n = std::size_t(graph.size());
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	threads = unsigned(std::min<std::size_t>(threads, std::max<std::size_t>(n_greedy, 1)));
+
+	auto work = [&](unsigned t, std::uint64_t seed) {
+		Rng local(seed);
+		GreedyConstruction greedy(graph, alpha);
+		for (std::size_t i = t; i < count; i += threads) {
+			genomes[i] = Genome(n);
+			if (i < n_greedy)
+				greedy(genomes[i], local);
+			else
+				genomes[i].randomize(local);
+		}
+	};
+	std::vector<std::uint64_t> seeds(threads);
+	for (auto& s : seeds)
+		s = rng();
+	std::vector<std::thread> pool;
+	for (unsigned t = 1; t < threads; t++)
+		pool.emplace_back(work, t, seeds[t]);
+	work(0, seeds[0]);
+	for (auto& th : pool)
+		th.join();
+}
+
+} // namespace maxcut
@@ -0,0 +1,37 @@
+// Convert a "V E" + "u v w" text graph into a binary graph file (graph_file.h)
+// usage: convert <input.txt> <output> [weight bytes: 1, 2 or 4; narrowest that fits by default]
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include "graph.h"
+#include "graph_file.h"
+#include "loader.h"
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+	if (argc < 3) {
+		cerr << "usage: convert <input.txt> <output> [1|2|4]\n";
+		return 1;
+	}
+	size_t weight_bytes = (argc > 3 ? size_t(atoi(argv[3])) : 0);
+
+	maxcut::Graph graph;
+	if (!maxcut::load_graph_mapped(argv[1], graph)) {
+		cerr << "cannot read " << argv[1] << "\n";
+		return 1;
+	}
+	if (!maxcut::write_graph_file(argv[2], graph, weight_bytes)) {
+		cerr << "cannot write " << argv[2] << (weight_bytes ? " (do the weights fit that width?)" : "") << "\n";
+		return 1;
+	}
+
+	maxcut::GraphFile file;
+	if (!file.open(argv[2], true)) {
+		cerr << "written file does not verify: " << argv[2] << "\n";
+		return 1;
+	}
+	cerr << graph.size() << " vertices, " << graph.edge_count() << " edges, " << file.weight_bytes() << "-byte weights, hash "
+		<< hex << file.hash() << "\n";
+	return 0;
+}
@@ -0,0 +1,99 @@
+#pragma once
+// Crossover policies
+// Every policy provides
+//   void operator()(const Genome& a, long long cost_a, const Genome& b, long long cost_b, Genome& child, Rng&)
+// and overwrites every gene of child (already sized like the parents).
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include "genome.h"
+
+namespace maxcut {
+
+// child = head[0, cut) + tail[cut, n), copied word by word
+template <class Genome>
+void splice(const Genome& head, const Genome& tail, std::size_t cut, Genome& child) {
+	std::size_t w = cut / 64;
+	for (std::size_t i = 0; i < w; i++)
+		child.set_word(i, head.word(i));
+	if (w < child.word_count()) {
+		std::uint64_t m = (std::uint64_t(1) << (cut % 64)) - 1; // low bits from head
+		child.set_word(w, (head.word(w) & m) | (tail.word(w) & ~m));
+	}
+	for (std::size_t i = w + 1; i < child.word_count(); i++)
+		child.set_word(i, tail.word(i));
+}
+
+// Each gene comes from the first parent with probability p_first (basic GA: 0.5, 20211301: 0.6)
+class UniformCrossover {
+private:
+	double p_first; // probability of taking the first parent's gene
+
+public:
+	explicit UniformCrossover(double p_first = 0.5) : p_first(p_first) {}
+
+	template <class Genome>
+	void operator()(const Genome& a, long long, const Genome& b, long long, Genome& child, Rng& rng) const {
+		std::bernoulli_distribution first(p_first);
+		for (std::size_t i = 0; i < child.word_count(); i++) {
+			std::uint64_t m; // 1 bits take the first parent
+			if (p_first == 0.5)
+				m = rng();
+			else {
+				m = 0;
+				for (int bit = 0; bit < 64; bit++)
+					m |= std::uint64_t(first(rng)) << bit;
+			}
+			child.set_word(i, (a.word(i) & m) | (b.word(i) & ~m));
+		}
+		child.mask_tail();
+	}
+};
+
+// Fixed cut point at a fraction of the genome: child = b[0, cut) + a[cut, n) (20211343: half)
+class PrefixCrossover {
+private:
+	double fraction; // cut point as a fraction of the genome length
+
+public:
+	explicit PrefixCrossover(double fraction = 0.5) : fraction(fraction) {}
+
+	template <class Genome>
+	void operator()(const Genome& a, long long, const Genome& b, long long, Genome& child, Rng&) const {
+		splice(b, a, std::size_t(double(a.size()) * fraction), child);
+	}
+};
+
+// With probability rate, the fitter parent gives the first `fraction` of the genes and the other the rest;
+// otherwise the child is a copy of the first parent (20211291: 3/4, 0.8)
+class FitterPrefixCrossover {
+private:
+	double fraction; // share of the fitter parent
+	double rate; // crossover probability
+
+public:
+	explicit FitterPrefixCrossover(double fraction = 0.75, double rate = 0.8) : fraction(fraction), rate(rate) {}
+
+	template <class Genome>
+	void operator()(const Genome& a, long long cost_a, const Genome& b, long long cost_b, Genome& child, Rng& rng) const {
+		if (std::uniform_real_distribution<double>(0, 1)(rng) >= rate) {
+			child = a;
+			return;
+		}
+		const Genome& fitter = (cost_a >= cost_b ? a : b);
+		const Genome& other = (cost_a >= cost_b ? b : a);
+		splice(fitter, other, std::size_t(double(a.size()) * fraction), child);
+	}
+};
+
+// Random cut point: child = a[0, p) + b[p, n) (20211327)
+class OnePointCrossover {
+public:
+	template <class Genome>
+	void operator()(const Genome& a, long long, const Genome& b, long long, Genome& child, Rng& rng) const {
+		std::size_t p = std::uniform_int_distribution<std::size_t>(0, a.size() - 1)(rng);
+		splice(a, b, p, child);
+	}
+};
+
+} // namespace maxcut
@@ -0,0 +1,92 @@
+#pragma once
+// Shared time limit service: every GA checks its deadline the same way.
+// * Based on steady_clock (monotonic), so neither CPU time (clock()) nor wall clock changes affect it.
+// * expired() does not read the clock on every call; it adapts how often it reads it (about once per ms).
+// * After SIGINT/SIGTERM, or once the incumbent reaches a proven upper bound, every Deadline reports expired at once.
+#include <atomic>
+#include <chrono>
+#include <csignal>
+
+namespace maxcut {
+
+// Set by the stop signal handler; engines see it through Deadline
+inline volatile std::sig_atomic_t g_stop_signal = 0;
+
+// Set by Incumbent when its cost reaches the target (a proven upper bound, see bounds.h): nothing better exists
+inline std::atomic<bool> g_optimum_reached{ false };
+
+// Whether the engines should stop early: a stop signal was received or the optimum was reached
+inline bool stop_requested() { return g_stop_signal != 0 || g_optimum_reached.load(std::memory_order_relaxed); }
+
+class Deadline {
+public:
+	using clock = std::chrono::steady_clock;
+
+private:
+	clock::time_point start; // start of measurement
+	clock::time_point end; // deadline
+	clock::time_point last_check; // last time the clock was read
+	unsigned stride = 1; // expired() calls between clock reads
+	unsigned counter = 0; // expired() calls since the last clock read
+	bool is_over = false; // sticky once expired
+
+public:
+	// seconds from now
+	explicit Deadline(double seconds = 180.0) : Deadline(clock::now(), seconds) {}
+	// seconds from the given start
+	Deadline(clock::time_point start, double seconds) {
+		this->start = start;
+		this->end = start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(seconds));
+		this->last_check = start;
+	}
+
+	// Cheap enough to call from inner loops
+	bool expired() {
+		if (is_over)
+			return true;
+		if (stop_requested()) // signal and optimum are checked every call
+			return is_over = true;
+		if (++counter < stride)
+			return false;
+		clock::time_point now = clock::now();
+		// keep clock reads about 1ms apart
+		clock::duration gap = now - last_check;
+		if (gap < std::chrono::microseconds(500) && stride < (1u << 16))
+			stride *= 2;
+		else if (gap > std::chrono::milliseconds(2) && stride > 1)
+			stride /= 2;
+		return reached(now);
+	}
+
+	// Read the clock now; leaves the stride alone, since forced reads say nothing about how often expired() is called
+	bool check() { return reached(clock::now()); }
+
+private:
+	bool reached(clock::time_point now) {
+		counter = 0;
+		last_check = now;
+		if (now >= end || stop_requested())
+			is_over = true;
+		return is_over;
+	}
+
+public:
+	// seconds since start
+	double elapsed() const { return std::chrono::duration<double>(clock::now() - start).count(); }
+	// seconds left, 0 when expired
+	double remaining() const {
+		double left = std::chrono::duration<double>(end - clock::now()).count();
+		return left > 0 ? left : 0;
+	}
+	// total budget in seconds
+	double budget() const { return std::chrono::duration<double>(end - start).count(); }
+
+	// Sub-deadline using a fraction of the remaining time; never ends after this one
+	Deadline slice(double fraction) const {
+		if (fraction > 1)
+			fraction = 1;
+		return Deadline(remaining() * (fraction > 0 ? fraction : 0));
+	}
+};
+
+} // namespace maxcut
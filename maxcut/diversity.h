@@ -0,0 +1,126 @@
+#pragma once
+// Population diversity and restart policy
+// * Diversity keeps per-locus one-counts and is updated as individuals enter or leave the population.
+//   The mean pairwise Hamming distance then follows from the counts alone:
+//   sum over loci of ones * (P - ones) / (P * (P - 1) / 2), so it never compares genomes pairwise.
+// * RestartPolicy decides when a converged population should keep its elites and re-seed the rest.
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <vector>
+
+namespace maxcut {
+
+class Diversity {
+private:
+	std::vector<int> ones; // number of individuals with bit 1 at each locus
+	long long count = 0; // population size
+	long long mixed = 0; // sum over loci of ones * (count - ones)
+
+public:
+	explicit Diversity(std::size_t length = 0) : ones(length, 0) {}
+
+	// Forget every individual
+	void clear() {
+		std::fill(ones.begin(), ones.end(), 0);
+		count = 0;
+		mixed = 0;
+	}
+
+	// Add an individual; bit(i) is the 0/1 gene at locus i
+	template <class Bit>
+	void add(Bit bit) {
+		long long m = 0;
+		for (std::size_t i = 0; i < ones.size(); i++) {
+			ones[i] += bit(i) ? 1 : 0;
+			long long c = ones[i];
+			m += c * (count + 1 - c);
+		}
+		count++;
+		mixed = m;
+	}
+
+	// Remove an individual previously added with the same genes
+	template <class Bit>
+	void remove(Bit bit) {
+		long long m = 0;
+		for (std::size_t i = 0; i < ones.size(); i++) {
+			ones[i] -= bit(i) ? 1 : 0;
+			long long c = ones[i];
+			m += c * (count - 1 - c);
+		}
+		count--;
+		mixed = m;
+	}
+
+	// Replace an individual previously added with the genes out(i) by one with the genes in(i), in one pass;
+	// only the loci where they differ change the sum
+	template <class Out, class In>
+	void exchange(Out out, In in) {
+		for (std::size_t i = 0; i < ones.size(); i++) {
+			int d = (in(i) ? 1 : 0) - (out(i) ? 1 : 0);
+			if (d == 0)
+				continue;
+			long long c = ones[i];
+			mixed += d > 0 ? count - 2 * c - 1 : 2 * c - count - 1;
+			ones[i] += d;
+		}
+	}
+
+	// Population size
+	long long size() const { return count; }
+	// Number of loci
+	std::size_t length() const { return ones.size(); }
+	// Individuals with bit 1 at locus i
+	int ones_at(std::size_t i) const { return ones[i]; }
+
+	// Mean Hamming distance over all pairs of individuals
+	double mean_hamming() const {
+		if (count < 2)
+			return 0;
+		return double(mixed) / (double(count) * double(count - 1) / 2);
+	}
+	// Mean Hamming distance divided by the genome length: 0 (all equal) to about 0.5 (random)
+	double normalized() const { return ones.empty() ? 0 : mean_hamming() / double(ones.size()); }
+};
+
+class RestartPolicy {
+private:
+	double min_diversity; // normalized diversity below which the population counts as converged
+	int patience; // generations without improvement before a restart
+	int stall = 0; // generations since the best cost last improved
+	long long best = LLONG_MIN; // best cost seen since the last restart
+	int restarts = 0; // number of restarts so far
+
+public:
+	explicit RestartPolicy(double min_diversity = 0.01, int patience = 100) {
+		this->min_diversity = min_diversity;
+		this->patience = patience;
+	}
+
+	// Call once per generation; true when the engine should restart now
+	bool update(double diversity, long long generation_best) {
+		if (generation_best > best) {
+			best = generation_best;
+			stall = 0;
+		}
+		else
+			stall++;
+		if (diversity >= min_diversity && stall < patience)
+			return false;
+		stall = 0;
+		best = LLONG_MIN; // the elites carry the best solution over, so the next run starts counting again
+		restarts++;
+		return true;
+	}
+
+	// Number of elites to keep from a population of the given size
+	static std::size_t elite_count(std::size_t population) {
+		std::size_t k = population / 20;
+		return k > 0 ? k : 1;
+	}
+
+	int restart_count() const { return restarts; }
+};
+
+} // namespace maxcut
@@ -0,0 +1,190 @@
+#pragma once
+// Estimation-of-distribution engine (PBIL / UMDA): instead of a population it keeps one probability per vertex
+// p[v] = P(v on side 1) and per batch
+//   sample `batch` genomes from p -> evaluate them as one batch -> move p toward the elite fraction's frequencies
+// p[v] is stored as a 32-bit threshold, so a gene is drawn as (32 random bits < threshold) and a genome word
+// is built from 64 comparisons in a branch-free loop the compiler vectorizes. Memory is O(V + batch * V / 64)
+// words instead of a population of P genomes.
+// A partition and its complement are the same cut, so each elite is read in the orientation closer to the
+// model's current mode before it is counted; otherwise complementary elites cancel and p never leaves 1/2.
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+#include "deadline.h"
+#include "diversity.h"
+#include "genome.h"
+#include "incumbent.h"
+
+namespace maxcut {
+
+struct EdaConfig {
+	std::size_t batch = 256; // genomes sampled and evaluated per step
+	double elite_fraction = 0.1; // share of each batch that updates the model
+	double learning_rate = 0.1; // PBIL rate; 1 gives UMDA (the model becomes the elite frequencies)
+	double margin = 0; // p is kept in [margin, 1 - margin]; 0 for 1 / V
+	std::uint64_t seed = 0; // random seed, 0 for std::random_device
+	double min_diversity = 0.01; // expected normalized distance of two samples below which the model is reset
+	int patience = 50; // batches without improvement before the model is reset
+	unsigned threads = 0; // sampling threads, 0 for one per hardware thread
+};
+
+template <class Genome, class Evaluator>
+class DistributionEngine {
+public:
+	using genome_type = Genome;
+
+private:
+	Evaluator evaluate;
+	EdaConfig config;
+	std::size_t n; // genome length (vertex count)
+	Rng rng;
+
+	std::vector<double> p; // P(v on side 1)
+	std::vector<std::uint32_t> threshold; // p scaled to 2^32, what the sampler compares against
+	std::vector<Genome> samples; // current batch
+	std::vector<long long> costs; // costs[i] of samples[i]
+	std::vector<std::size_t> order; // scratch: batch indices by cost
+	std::vector<std::uint32_t> ones; // scratch: elite one-counts per vertex
+	Incumbent* incumbent = nullptr; // anytime output
+	RestartPolicy restart_policy;
+	Genome best; // best genome found
+	long long best_cost = LLONG_MIN;
+	std::size_t batches = 0; // completed batches
+
+public:
+	DistributionEngine(std::size_t n, Evaluator evaluate, EdaConfig config = EdaConfig())
+		: evaluate(evaluate), config(config), n(n), restart_policy(config.min_diversity, config.patience) {
+		this->config.batch = std::max<std::size_t>(this->config.batch, 2);
+		if (this->config.margin <= 0)
+			this->config.margin = 1.0 / double(std::max<std::size_t>(n, 2));
+		rng.seed(config.seed != 0 ? config.seed : (std::uint64_t(std::random_device{}()) << 32) ^ std::random_device{}());
+		reset();
+	}
+
+	// Report every improvement to this incumbent
+	void set_incumbent(Incumbent* incumbent) { this->incumbent = incumbent; }
+
+	// Sample and update until the deadline; returns the best cost found (LLONG_MIN if nothing was evaluated)
+	long long run(Deadline& deadline) {
+		samples.resize(config.batch, Genome(n));
+		costs.resize(config.batch);
+		while (!deadline.expired()) {
+			sample();
+			evaluate.batch(samples.data(), samples.size(), costs.data());
+			long long batch_best = LLONG_MIN;
+			for (std::size_t i = 0; i < samples.size(); i++) {
+				offer(samples[i], costs[i]);
+				batch_best = std::max(batch_best, costs[i]);
+			}
+			update();
+			batches++;
+			if (restart_policy.update(expected_distance(), batch_best))
+				reset();
+		}
+		return best_cost;
+	}
+
+	const Genome& best_genome() const { return best; }
+	long long best_value() const { return best_cost; }
+	// Batches, reported where the GA engines report generations
+	std::size_t generation_count() const { return batches; }
+	int restart_count() const { return restart_policy.restart_count(); }
+	const std::vector<double>& model() const { return p; }
+
+private:
+	// Track the best genome and forward improvements to the incumbent (printed side: the one holding vertex 1)
+	void offer(const Genome& g, long long cost) {
+		if (cost <= best_cost)
+			return;
+		best_cost = cost;
+		best = g;
+		if (incumbent != nullptr)
+			incumbent->offer(cost, n, [&](std::size_t i) { return g.get(i) == g.get(0); });
+	}
+
+	// Uniform model
+	void reset() {
+		p.assign(n, 0.5);
+		threshold.assign(n, std::uint32_t(1) << 31);
+	}
+
+	// Fill samples from the model; rows are split over threads when the batch is large enough to pay for them
+	void sample() {
+		unsigned threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+		if (n * samples.size() < (std::size_t(1) << 20))
+			threads = 1;
+		std::vector<std::uint64_t> seeds(threads);
+		for (auto& s : seeds)
+			s = rng();
+		auto work = [&](unsigned t) {
+			Rng local(seeds[t]);
+			std::vector<std::uint32_t> draws(64);
+			for (std::size_t i = t; i < samples.size(); i += threads) {
+				Genome& g = samples[i];
+				for (std::size_t w = 0; w * 64 < n; w++) {
+					std::size_t base = w * 64, len = std::min<std::size_t>(64, n - base);
+					for (std::size_t k = 0; k < len; k += 2) {
+						std::uint64_t r = local();
+						draws[k] = std::uint32_t(r);
+						draws[k + 1] = std::uint32_t(r >> 32);
+					}
+					const std::uint32_t* th = threshold.data() + base;
+					std::uint64_t word = 0;
+					for (std::size_t k = 0; k < len; k++)
+						word |= std::uint64_t(draws[k] < th[k]) << k;
+					g.set_word(w, word);
+				}
+			}
+		};
+		std::vector<std::thread> pool;
+		for (unsigned t = 1; t < threads; t++)
+			pool.emplace_back(work, t);
+		work(0);
+		for (auto& th : pool)
+			th.join();
+	}
+
+	// Move p toward the vertex frequencies of the best elite_fraction of the batch
+	void update() {
+		std::size_t m = std::max<std::size_t>(1, std::size_t(double(samples.size()) * config.elite_fraction));
+		order.resize(samples.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::partial_sort(order.begin(), order.begin() + m, order.end(),
+			[&](std::size_t a, std::size_t b) { return costs[a] > costs[b]; });
+
+		// the model's mode as a genome, to orient each elite
+		Genome mode(n);
+		for (std::size_t v = 0; v < n; v++)
+			mode.set(v, p[v] > 0.5);
+		ones.assign(n, 0);
+		for (std::size_t j = 0; j < m; j++) {
+			const Genome& g = samples[order[j]];
+			bool flip = 2 * hamming(g, mode) > n;
+			for (std::size_t v = 0; v < n; v++)
+				ones[v] += g.get(v) != flip;
+		}
+
+		double rate = config.learning_rate, lo = config.margin, hi = 1 - config.margin;
+		for (std::size_t v = 0; v < n; v++) {
+			double q = (1 - rate) * p[v] + rate * double(ones[v]) / double(m);
+			p[v] = std::min(hi, std::max(lo, q));
+			threshold[v] = std::uint32_t(std::min(4294967295.0, p[v] * 4294967296.0));
+		}
+	}
+
+	// Expected normalized Hamming distance between two samples, comparable to Diversity::normalized()
+	double expected_distance() const {
+		double sum = 0;
+		for (double q : p)
+			sum += 2 * q * (1 - q);
+		return n ? sum / double(n) : 0;
+	}
+};
+
+} // namespace maxcut
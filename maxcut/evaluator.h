@@ -0,0 +1,70 @@
+#pragma once
+// Cut evaluation: cost of a genome is the total weight of the edges whose endpoints are on different sides
+// The passes read the compact copy of the weights (weights.h), so an unweighted graph is scored by counting
+// cut edges and a small weight range by reading int8 / int16 weights; costs are summed in 64 bits.
+#include <cstddef>
+#include <memory>
+#include "graph.h"
+#include "sliced.h"
+#include "weights.h"
+
+namespace maxcut {
+
+class CutEvaluator {
+private:
+	const Graph* graph; // problem graph
+	std::shared_ptr<const CompactEdges> compact; // its edges and CSR weights, shared by every copy
+	mutable SlicedCut sliced; // batch evaluator; its scratch buffers make batch() single-threaded per copy
+
+public:
+	// batches smaller than this are evaluated one genome at a time
+	static constexpr std::size_t min_sliced_batch = 8;
+
+	explicit CutEvaluator(const Graph& graph)
+		: graph(&graph), compact(std::make_shared<const CompactEdges>(graph)), sliced(std::size_t(graph.size()), compact) {}
+
+	const Graph& problem() const { return *graph; }
+	// Storage chosen for the weights
+	WeightKind weight_kind() const { return compact->kind; }
+
+	// Cut weight of a genome
+	template <class Genome>
+	long long operator()(const Genome& g) const {
+		const EdgeEnds* ends = compact->ends.data();
+		return compact->edge_w.visit([&](auto w) {
+			long long cost = 0;
+			for (std::size_t i = 0, m = compact->size(); i < m; i++) {
+				if (g.get(ends[i].u) != g.get(ends[i].v))
+					cost += w[i];
+			}
+			return cost;
+		});
+	}
+
+	// Cut weights of genomes[0 .. count) into costs, bit-sliced (one pass over the edges per 64/256 genomes)
+	template <class Genome>
+	void batch(const Genome* genomes, std::size_t count, long long* costs) const {
+		if (count < min_sliced_batch) {
+			for (std::size_t i = 0; i < count; i++)
+				costs[i] = (*this)(genomes[i]);
+			return;
+		}
+		sliced(genomes, count, costs);
+	}
+
+	// Change of the cut weight when vertex v moves to the other side: O(deg v)
+	template <class Genome>
+	long long flip_gain(const Genome& g, int v) const {
+		bool side = g.get(v);
+		return compact->adj_w.visit([&](auto w) {
+			long long gain = 0;
+			for (int k = graph->offset[v]; k < graph->offset[v + 1]; k++) {
+				// an uncut edge becomes cut (+w), a cut edge becomes uncut (-w)
+				gain += (g.get(graph->adj[k]) == side) ? w[k] : -w[k];
+			}
+			return gain;
+		});
+	}
+};
+
+} // namespace maxcut
@@ -0,0 +1,295 @@
+#pragma once
+// Exact branch and bound for graphs of up to 64 vertices
+// Vertices are renumbered into positions (see order below) and assigned in position order, the first one of a
+// search fixed to side 0 since a cut and its complement are the same. Sides and neighbourhoods are 64-bit
+// masks. For every unassigned position u the search keeps gain[s][u], the weight from u to the assigned
+// positions on side s, so u will add gain[0][u] or gain[1][u] to the cut; the bound at a node is
+//   cut so far + sum over unassigned u of max(gain[0][u], gain[1][u]) + best cut among the unassigned
+// and each assignment updates it in O(degree). The last term comes from Russian doll search: the suffixes
+// (positions n-1 .. n-1, then n-2 .. n-1, ...) are solved in turn, each bounded by the optima of the shorter
+// ones, so the final search over all positions is tightly bounded from the start.
+// Each stage is split into subtrees by the sides of its first few free positions, which threads take from a
+// shared counter; the stage's best cut is shared so every thread prunes against it. Multi-start local
+// search supplies the first answer; when the deadline cuts the search short that answer (or a better one
+// found since) is kept and proven() stays false.
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "deadline.h"
+#include "flip_state.h"
+#include "genome.h"
+#include "graph.h"
+#include "incumbent.h"
+#include "sliced.h"
+
+namespace maxcut {
+
+class ExactEngine {
+public:
+	static constexpr int max_vertices = 64;
+
+private:
+	const Graph* graph;
+	unsigned threads; // search threads, 0 for one per hardware thread
+	std::uint64_t seed;
+	Incumbent* incumbent = nullptr; // anytime output
+	int n = 0;
+	std::vector<int> order; // position -> vertex
+	std::vector<long long> weight; // n x n by position, parallel edges merged
+	std::vector<std::uint64_t> adj; // positions joined to each position by a non-zero weight
+	std::vector<long long> suffix; // suffix[p]: best cut among positions p .. n-1, suffix[n] = 0
+	std::vector<std::uint64_t> suffix_sides; // a partition attaining suffix[p] (bit = position's side)
+	std::vector<std::uint8_t> best; // best partition of the graph
+	long long best_cost = LLONG_MIN;
+	std::atomic<std::size_t> nodes{ 0 };
+	bool is_proven = false;
+
+	// A stage's shared result
+	struct Stage {
+		int first; // the stage searches positions first .. n-1
+		std::atomic<long long> cost; // best cut found
+		std::uint64_t sides = 0; // its partition, guarded by lock
+		std::mutex lock;
+		std::atomic<bool> stopped{ false }; // the deadline passed
+	};
+
+public:
+	ExactEngine(const Graph& graph, unsigned threads = 0, std::uint64_t seed = 0)
+		: graph(&graph), threads(threads), seed(seed) {}
+
+	// Report every improvement to this incumbent; a proven optimum becomes its target
+	void set_incumbent(Incumbent* incumbent) { this->incumbent = incumbent; }
+
+	long long run(Deadline& deadline) {
+		n = graph->size();
+		if (n == 0 || n > max_vertices)
+			return best_cost;
+		prepare();
+		local_search(deadline);
+
+		suffix.assign(std::size_t(n) + 1, 0);
+		suffix_sides.assign(std::size_t(n) + 1, 0);
+		for (int first = n - 1; first >= 0; first--) {
+			Stage stage;
+			stage.first = first;
+			// extend the next stage's optimum by position `first`, on whichever side cuts more of its edges
+			long long to[2] = { 0, 0 };
+			std::uint64_t rest = suffix_sides[std::size_t(first) + 1];
+			for (std::uint64_t m = adj[first] & above(first); m; m &= m - 1) {
+				int u = lowest_bit64(m);
+				to[(rest >> u) & 1] += weight[index(first, u)];
+			}
+			stage.cost = suffix[std::size_t(first) + 1] + std::max(to[0], to[1]);
+			stage.sides = to[0] >= to[1] ? ~rest & above(first) : rest; // position `first` on side 0
+			if (first == 0 && best_cost > stage.cost) {
+				stage.cost = best_cost;
+				stage.sides = 0;
+				for (int p = 0; p < n; p++)
+					stage.sides |= std::uint64_t(best[std::size_t(order[p])] != best[std::size_t(order[0])]) << p;
+			}
+			search(stage, deadline);
+			if (stage.stopped) {
+				if (first == 0)
+					keep(stage.cost, stage.sides); // the best cut the search got to
+				return best_cost;
+			}
+			suffix[first] = stage.cost;
+			suffix_sides[first] = stage.sides;
+		}
+
+		keep(suffix[0], suffix_sides[0]);
+		is_proven = true;
+		if (incumbent != nullptr)
+			incumbent->set_target(best_cost);
+		return best_cost;
+	}
+
+	const std::vector<std::uint8_t>& best_genome() const { return best; }
+	long long best_value() const { return best_cost; }
+	// Search nodes, reported where the GA engines report generations
+	std::size_t generation_count() const { return nodes.load(); }
+	int restart_count() const { return 0; }
+	// Whether best_value() is the maximum cut
+	bool proven() const { return is_proven; }
+
+private:
+	// Positions after p
+	static std::uint64_t above(int p) { return p >= 63 ? 0 : ~std::uint64_t(0) << (p + 1); }
+	std::size_t index(int a, int b) const { return std::size_t(a) * std::size_t(n) + std::size_t(b); }
+
+	// Order the vertices (each next one the most strongly tied to those before, by total |w|; ties to the
+	// larger total |w|) and build the position matrices. The last positions, solved first by the doll search,
+	// are then the loosely tied ones, and the early positions fix most of the weight near the root.
+	void prepare() {
+		std::vector<long long> dense(std::size_t(n) * std::size_t(n), 0), strength(std::size_t(n), 0);
+		for (const Edge& e : graph->edges) {
+			dense[std::size_t(e.u) * std::size_t(n) + std::size_t(e.v)] += e.w;
+			dense[std::size_t(e.v) * std::size_t(n) + std::size_t(e.u)] += e.w;
+		}
+		for (int v = 0; v < n; v++) {
+			for (int u = 0; u < n; u++)
+				strength[v] += std::abs(dense[std::size_t(v) * std::size_t(n) + std::size_t(u)]);
+		}
+		order.clear();
+		std::vector<long long> tie(std::size_t(n), 0);
+		std::vector<std::uint8_t> placed(std::size_t(n), 0);
+		for (int p = 0; p < n; p++) {
+			int pick = -1;
+			for (int v = 0; v < n; v++) {
+				if (!placed[v] && (pick < 0 || tie[v] > tie[pick] || (tie[v] == tie[pick] && strength[v] > strength[pick])))
+					pick = v;
+			}
+			placed[pick] = 1;
+			order.push_back(pick);
+			for (int u = 0; u < n; u++)
+				tie[u] += std::abs(dense[std::size_t(pick) * std::size_t(n) + std::size_t(u)]);
+		}
+		weight.assign(std::size_t(n) * std::size_t(n), 0);
+		adj.assign(std::size_t(n), 0);
+		for (int a = 0; a < n; a++) {
+			for (int b = 0; b < n; b++) {
+				long long w = dense[std::size_t(order[a]) * std::size_t(n) + std::size_t(order[b])];
+				weight[index(a, b)] = w;
+				if (w != 0)
+					adj[a] |= std::uint64_t(1) << b;
+			}
+		}
+	}
+
+	// Offer a partition of the positions if it beats the best
+	void keep(long long cost, std::uint64_t sides_by_position) {
+		if (cost <= best_cost)
+			return;
+		std::vector<std::uint8_t> sides(std::size_t(n), 0);
+		for (int p = 0; p < n; p++)
+			sides[std::size_t(order[p])] = std::uint8_t((sides_by_position >> p) & 1);
+		offer(cost, sides);
+	}
+
+	// Single-flip local optima from random starts, for a first answer and a first bound
+	void local_search(Deadline& deadline) {
+		Rng rng(seed != 0 ? seed : (std::uint64_t(std::random_device{}()) << 32) ^ std::random_device{}());
+		FlipState state(*graph);
+		for (int round = 0; round < 4 * n && !deadline.expired(); round++) {
+			state.assign([&](std::size_t) { return (rng() >> 63) != 0; });
+			state.descend();
+			if (state.cut() > best_cost)
+				offer(state.cut(), state.partition());
+		}
+	}
+
+	void offer(long long cost, const std::vector<std::uint8_t>& sides) {
+		best_cost = cost;
+		best = sides;
+		if (incumbent != nullptr)
+			incumbent->offer(best_cost, best.size(), [&](std::size_t i) { return best[i] == best[0]; });
+	}
+
+	// One thread's search state for positions stage.first .. n-1
+	struct Search {
+		const ExactEngine* engine;
+		Stage* stage;
+		Deadline deadline; // a copy per thread: Deadline is not shared between threads
+		long long gain[2][max_vertices];
+		long long cut = 0; // among the assigned positions
+		long long loose = 0; // sum of max(gain[0][u], gain[1][u]) over the unassigned u
+		std::uint64_t sides = 0;
+		std::size_t nodes = 0;
+
+		Search(const ExactEngine* engine, Stage* stage, const Deadline& deadline) : engine(engine), stage(stage), deadline(deadline) {
+			for (int s = 0; s < 2; s++)
+				std::fill(gain[s], gain[s] + max_vertices, 0);
+		}
+
+		void assign(int p, int s) {
+			cut += gain[s ^ 1][p];
+			loose -= std::max(gain[0][p], gain[1][p]);
+			sides |= std::uint64_t(s) << p;
+			for (std::uint64_t m = engine->adj[p] & above(p); m; m &= m - 1) {
+				int u = lowest_bit64(m);
+				long long before = std::max(gain[0][u], gain[1][u]);
+				gain[s][u] += engine->weight[engine->index(p, u)];
+				loose += std::max(gain[0][u], gain[1][u]) - before;
+			}
+		}
+
+		void unassign(int p, int s, long long old_cut, long long old_loose) {
+			for (std::uint64_t m = engine->adj[p] & above(p); m; m &= m - 1)
+				gain[s][lowest_bit64(m)] -= engine->weight[engine->index(p, lowest_bit64(m))];
+			sides &= ~(std::uint64_t(1) << p);
+			cut = old_cut;
+			loose = old_loose;
+		}
+
+		// Positions before p are assigned
+		void dfs(int p) {
+			if (p == engine->n) {
+				if (cut > stage->cost.load(std::memory_order_relaxed)) {
+					std::lock_guard<std::mutex> guard(stage->lock);
+					if (cut > stage->cost.load(std::memory_order_relaxed)) {
+						stage->sides = sides;
+						stage->cost.store(cut, std::memory_order_relaxed);
+					}
+				}
+				return;
+			}
+			if (cut + loose + engine->suffix[std::size_t(p)] <= stage->cost.load(std::memory_order_relaxed))
+				return;
+			nodes++;
+			if (stage->stopped.load(std::memory_order_relaxed) || deadline.expired()) {
+				stage->stopped.store(true, std::memory_order_relaxed);
+				return;
+			}
+			// the side that cuts more of p's assigned edges first
+			int first = gain[0][p] >= gain[1][p] ? 1 : 0;
+			long long old_cut = cut, old_loose = loose;
+			for (int s : { first, first ^ 1 }) {
+				assign(p, s);
+				dfs(p + 1);
+				unassign(p, s, old_cut, old_loose);
+			}
+		}
+	};
+
+	// Solve stage: its first position on side 0, the subtrees under the next few positions shared out
+	void search(Stage& stage, Deadline& deadline) {
+		int free_positions = n - stage.first - 1;
+		unsigned workers = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+		int split = 0; // positions fixed per subtree: about 16 subtrees per thread on the larger stages
+		if (workers > 1 && free_positions >= 20) {
+			while (split < free_positions && (std::size_t(1) << split) < std::size_t(workers) * 16)
+				split++;
+		}
+		else
+			workers = 1;
+		std::atomic<std::size_t> next{ 0 };
+		std::size_t subtrees = std::size_t(1) << split;
+		auto work = [&]() {
+			std::size_t explored = 0;
+			for (std::size_t t; (t = next.fetch_add(1)) < subtrees && !stage.stopped.load(std::memory_order_relaxed);) {
+				Search s(this, &stage, deadline);
+				s.assign(stage.first, 0);
+				for (int k = 0; k < split; k++)
+					s.assign(stage.first + 1 + k, int((t >> k) & 1));
+				s.dfs(stage.first + 1 + split);
+				explored += s.nodes;
+			}
+			nodes += explored;
+		};
+		std::vector<std::thread> pool;
+		for (unsigned i = 1; i < workers; i++)
+			pool.emplace_back(work);
+		work();
+		for (auto& th : pool)
+			th.join();
+	}
+};
+
+} // namespace maxcut
@@ -0,0 +1,79 @@
+#pragma once
+// A partition with incrementally maintained flip gains, for move-based search
+// gain[v] is the change of the cut weight when v alone changes side:
+//   gain[v] = sum over neighbours u of w(u, v) * (side[u] == side[v] ? +1 : -1)
+// Flipping v adds gain[v] to the cut, negates gain[v] and moves each neighbour's gain by 2 w, so a move is
+// evaluated in O(1) and applied in O(deg v) over the CSR arrays.
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "graph.h"
+
+namespace maxcut {
+
+class FlipState {
+private:
+	const Graph* graph;
+	std::vector<std::uint8_t> sides; // 0 / 1 per vertex
+	std::vector<long long> gains; // see above
+	long long cut_weight = 0;
+
+public:
+	explicit FlipState(const Graph& graph) : graph(&graph) {}
+
+	// Start from the partition side(v); O(E)
+	template <class Side>
+	void assign(Side side) {
+		std::size_t n = std::size_t(graph->size());
+		sides.resize(n);
+		for (std::size_t v = 0; v < n; v++)
+			sides[v] = std::uint8_t(side(v) ? 1 : 0);
+		gains.assign(n, 0);
+		cut_weight = 0;
+		for (std::size_t v = 0; v < n; v++) {
+			for (int k = graph->offset[v]; k < graph->offset[v + 1]; k++) {
+				bool same = sides[v] == sides[graph->adj[k]];
+				gains[v] += same ? graph->adj_w[k] : -graph->adj_w[k];
+				if (!same && std::size_t(graph->adj[k]) > v)
+					cut_weight += graph->adj_w[k];
+			}
+		}
+	}
+
+	const Graph& problem() const { return *graph; }
+	std::size_t size() const { return sides.size(); }
+	long long cut() const { return cut_weight; }
+	long long gain(int v) const { return gains[v]; }
+	bool side(int v) const { return sides[v] != 0; }
+	const std::vector<std::uint8_t>& partition() const { return sides; }
+
+	// Move v to the other side
+	void flip(int v) {
+		cut_weight += gains[v];
+		gains[v] = -gains[v];
+		std::uint8_t s = sides[v] ^= 1;
+		for (int k = graph->offset[v]; k < graph->offset[v + 1]; k++) {
+			int u = graph->adj[k];
+			long long d = 2 * (long long)graph->adj_w[k];
+			gains[u] += (sides[u] == s) ? d : -d;
+		}
+	}
+
+	// Flip improving vertices until none is left (a local optimum for single flips); returns the flips made
+	std::size_t descend() {
+		std::size_t flips = 0;
+		for (bool improved = true; improved;) {
+			improved = false;
+			for (std::size_t v = 0; v < sides.size(); v++) {
+				if (gains[v] > 0) {
+					flip(int(v));
+					flips++;
+					improved = true;
+				}
+			}
+		}
+		return flips;
+	}
+};
+
+} // namespace maxcut
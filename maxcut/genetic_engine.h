@@ -0,0 +1,282 @@
+#pragma once
+// Policy-based genetic algorithm engine
+// GeneticEngine<Genome, Evaluator, Selection, Crossover, Mutation, Replacement> runs
+//   initialize -> (prepare selection -> select, cross, mutate offspring_count children -> evaluate them as one
+//   batch -> replace)*
+// until the deadline. Operators are template parameters held by value, so the whole generation loop is
+// compiled for one combination and inlined; there is no virtual dispatch. See variants.h for the ported GAs.
+// Every genome the engine creates is canonicalized (gene 0 unset), so a cut has one representation in the
+// population and complementary parents do not wreck each other in crossover.
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+#include "construction.h"
+#include "deadline.h"
+#include "diversity.h"
+#include "genome.h"
+#include "incumbent.h"
+#include "path_relinking.h"
+#include "population.h"
+
+namespace maxcut {
+
+struct EngineConfig {
+	std::size_t population_size = 200; // individuals in the population
+	std::size_t offspring_count = 200; // children per generation
+	std::uint64_t seed = 0; // random seed, 0 for std::random_device
+	bool restart = true; // keep the elites and re-seed the rest when the population converges
+	double min_diversity = 0.01; // see RestartPolicy
+	int patience = 50; // see RestartPolicy, counted in population turnovers
+	double greedy_fraction = 0.5; // share of new (initial and re-seeded) genomes built by GreedyConstruction
+	double grasp_alpha = 0.3; // restricted candidate list width of GreedyConstruction
+	unsigned threads = 0; // construction and relinking threads, 0 for one per hardware thread
+	std::size_t relink_pairs = 0; // elites path-relinked toward the best once per population turnover, 0: off
+};
+
+template <class Genome, class Evaluator, class Selection, class Crossover, class Mutation, class Replacement>
+class GeneticEngine {
+public:
+	using genome_type = Genome;
+	using population_type = Population<Genome>;
+
+private:
+	Evaluator evaluate;
+	Selection selection;
+	Crossover crossover;
+	Mutation mutation;
+	Replacement replacement;
+	EngineConfig config;
+	std::size_t n; // genome length (vertex count)
+	Rng rng;
+
+	population_type population; // current population
+	population_type offspring; // children of the current generation; slots are reused as buffers
+	Incumbent* incumbent = nullptr; // anytime output
+	RestartPolicy restart_policy;
+	Diversity diversity; // per-locus counts of the population, updated as individuals enter and leave
+	std::vector<std::uint8_t> touched; // scratch for track_replacement: slots already seen in the log
+	Genome best; // best genome found
+	long long best_cost = LLONG_MIN;
+	std::size_t generations = 0; // completed generations
+
+public:
+	GeneticEngine(std::size_t n, Evaluator evaluate, Selection selection, Crossover crossover, Mutation mutation,
+		Replacement replacement, EngineConfig config = EngineConfig())
+		: evaluate(evaluate), selection(selection), crossover(crossover), mutation(mutation), replacement(replacement),
+		config(config), n(n), restart_policy(config.min_diversity, config.patience), diversity(n) {
+		this->config.population_size = std::max<std::size_t>(this->config.population_size, 2);
+		this->config.offspring_count = std::max<std::size_t>(this->config.offspring_count, 1);
+		rng.seed(config.seed != 0 ? config.seed : (std::uint64_t(std::random_device{}()) << 32) ^ std::random_device{}());
+	}
+
+	// Report every improvement to this incumbent
+	void set_incumbent(Incumbent* incumbent) { this->incumbent = incumbent; }
+
+	// Evolve until the deadline; returns the best cost found (LLONG_MIN if nothing was evaluated)
+	long long run(Deadline& deadline) {
+		if (population.empty() && !initialize(deadline))
+			return best_cost;
+
+		// restart checks happen once per population turnover, so steady-state engines are not charged O(P n) per child
+		std::size_t epoch = std::max<std::size_t>(1, config.population_size / config.offspring_count);
+		while (!deadline.expired()) {
+			if (!generation(deadline))
+				break;
+			if (config.relink_pairs > 0 && generations % epoch == 0)
+				relink();
+			if (config.restart && generations % epoch == 0
+				&& restart_policy.update(diversity.normalized(), population.costs[population.best_index()]))
+				restart(deadline);
+		}
+		return best_cost;
+	}
+
+	const Genome& best_genome() const { return best; }
+	long long best_value() const { return best_cost; }
+	std::size_t generation_count() const { return generations; }
+	int restart_count() const { return restart_policy.restart_count(); }
+	const population_type& current_population() const { return population; }
+	Rng& random() { return rng; }
+
+private:
+	// Track the best genome and forward improvements to the incumbent (printed side: the one holding vertex 1)
+	void offer(const Genome& g, long long cost) {
+		if (cost <= best_cost)
+			return;
+		best_cost = cost;
+		best = g;
+		if (incumbent != nullptr)
+			incumbent->offer(cost, n, [&](std::size_t i) { return g.get(i) == g.get(0); });
+	}
+
+	// Initial population, part greedy and part random; false when the deadline passes first
+	bool initialize(Deadline& deadline) {
+		population.clear();
+		bool complete = add_new(population, config.population_size, deadline) == config.population_size;
+		recount();
+		return complete;
+	}
+
+	// Append new genomes (greedy_fraction of them greedy, the rest random) to pop until it holds `target`,
+	// evaluated as one batch; returns the new size
+	std::size_t add_new(population_type& pop, std::size_t target, Deadline& deadline) {
+		std::size_t first = pop.size();
+		if (target <= first || deadline.expired())
+			return first;
+		std::size_t count = target - first;
+		std::size_t n_greedy = std::min(count, std::size_t(double(count) * config.greedy_fraction + 0.5));
+		pop.genomes.resize(target);
+		// greedy genomes first, one per thread at a time so the deadline is checked while they are built (a
+		// greedy genome of a large graph takes a good fraction of a second); check() reads the clock every time
+		unsigned threads = config.threads ? config.threads : std::max(1u, std::thread::hardware_concurrency());
+		std::size_t built = 0, chunk = threads;
+		while (built < count && !deadline.check()) {
+			std::size_t c = std::min(chunk, count - built);
+			std::size_t greedy = (built < n_greedy) ? std::min(c, n_greedy - built) : 0;
+			construct_genomes(evaluate.problem(), pop.genomes.data() + first + built, c, greedy,
+				config.grasp_alpha, rng, config.threads);
+			for (std::size_t i = first + built; i < first + built + c; i++)
+				canonicalize(pop.genomes[i]);
+			built += c;
+		}
+		pop.genomes.resize(first + built);
+		pop.costs.resize(pop.genomes.size());
+		evaluate.batch(pop.genomes.data() + first, pop.size() - first, pop.costs.data() + first);
+		for (std::size_t i = first; i < pop.size(); i++)
+			offer(pop.genomes[i], pop.costs[i]);
+		return pop.size();
+	}
+
+	// One generation; false (and the population untouched) when the deadline passes before all children exist
+	bool generation(Deadline& deadline) {
+		selection.prepare(population);
+		offspring.genomes.resize(config.offspring_count);
+		offspring.costs.resize(config.offspring_count);
+		offspring.parents.resize(config.offspring_count);
+		for (std::size_t i = 0; i < config.offspring_count; i++) {
+			if (deadline.expired())
+				return false;
+			std::pair<std::size_t, std::size_t> p = selection.parents(population, rng);
+			offspring.parents[i] = p;
+			Genome& child = offspring.genomes[i];
+			if (child.size() != n)
+				child = Genome(n);
+			crossover(population.genomes[p.first], population.costs[p.first],
+				population.genomes[p.second], population.costs[p.second], child, rng);
+			mutation(child, rng);
+			canonicalize(child);
+		}
+		evaluate.batch(offspring.genomes.data(), config.offspring_count, offspring.costs.data());
+		for (std::size_t i = 0; i < config.offspring_count; i++)
+			offer(offspring.genomes[i], offspring.costs[i]);
+		population.exchanges.clear();
+		population.renewed = false;
+		replacement(population, offspring, rng);
+		track_replacement();
+		generations++;
+		return true;
+	}
+
+	// Path-relink the next relink_pairs elites toward the best one; a result replaces the worst individual
+	// when it is better and not already an elite
+	void relink() {
+		std::size_t m = std::min(config.relink_pairs + 1, population.size());
+		if (m < 2)
+			return;
+		std::vector<std::size_t> order(population.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::partial_sort(order.begin(), order.begin() + m, order.end(),
+			[&](std::size_t a, std::size_t b) { return population.costs[a] > population.costs[b]; });
+		std::vector<std::vector<std::uint8_t>> elites(m, std::vector<std::uint8_t>(n));
+		std::vector<std::pair<std::size_t, std::size_t>> pairs;
+		for (std::size_t j = 0; j < m; j++) {
+			for (std::size_t i = 0; i < n; i++)
+				elites[j][i] = population.genomes[order[j]].get(i);
+			if (j > 0)
+				pairs.emplace_back(j, 0);
+		}
+		std::vector<std::vector<std::uint8_t>> results;
+		std::vector<long long> costs;
+		relink_pairs(evaluate.problem(), elites, pairs, results, costs, config.threads);
+
+		Genome g(n);
+		for (std::size_t r = 0; r < results.size(); r++) {
+			for (std::size_t i = 0; i < n; i++)
+				g.set(i, results[r][i] != 0);
+			canonicalize(g);
+			std::size_t worst = population.worst_index();
+			if (costs[r] <= population.costs[worst])
+				continue;
+			bool known = false;
+			for (std::size_t j = 0; j < m && !known; j++)
+				known = cut_distance(g, population.genomes[order[j]]) == 0;
+			if (known)
+				continue;
+			offer(g, costs[r]);
+			const Genome& leaving = population.genomes[worst];
+			diversity.exchange([&](std::size_t i) { return leaving.get(i); }, [&](std::size_t i) { return g.get(i); });
+			population.genomes[worst] = g;
+			population.costs[worst] = costs[r];
+		}
+	}
+
+	// Count the whole population afresh
+	void recount() {
+		diversity.clear();
+		for (const Genome& g : population.genomes)
+			diversity.add([&](std::size_t i) { return g.get(i); });
+	}
+
+	// Update the counts from the replacement's log. A slot's first exchange sent the individual it held to that
+	// child's offspring slot, and any later exchange of the slot displaced a child that had just entered, so per
+	// slot only two genomes matter: the one now at its first exchange's offspring index left, the one now in the
+	// slot entered. Costs O(n) per slot that changed.
+	void track_replacement() {
+		if (population.renewed) {
+			recount();
+			return;
+		}
+		touched.resize(population.size());
+		for (const auto& x : population.exchanges) {
+			if (touched[x.first])
+				continue;
+			touched[x.first] = 1;
+			const Genome& left = offspring.genomes[x.second];
+			const Genome& entered = population.genomes[x.first];
+			diversity.exchange([&](std::size_t i) { return left.get(i); }, [&](std::size_t i) { return entered.get(i); });
+		}
+		for (const auto& x : population.exchanges)
+			touched[x.first] = 0;
+	}
+
+	// Keep the elites, re-seed the rest with new genomes
+	void restart(Deadline& deadline) {
+		std::size_t n_elites = std::min(RestartPolicy::elite_count(population.size()), population.size());
+		std::vector<std::size_t> order(population.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::partial_sort(order.begin(), order.begin() + n_elites, order.end(),
+			[&](std::size_t a, std::size_t b) { return population.costs[a] > population.costs[b]; });
+
+		for (std::size_t i = n_elites; i < order.size(); i++) {
+			const Genome& leaving = population.genomes[order[i]];
+			diversity.remove([&](std::size_t v) { return leaving.get(v); });
+		}
+		population_type next;
+		next.reserve(config.population_size);
+		for (std::size_t i = 0; i < n_elites; i++)
+			next.push_back(std::move(population.genomes[order[i]]), population.costs[order[i]]);
+		add_new(next, config.population_size, deadline);
+		for (std::size_t i = n_elites; i < next.size(); i++) {
+			const Genome& entering = next.genomes[i];
+			diversity.add([&](std::size_t v) { return entering.get(v); });
+		}
+		population = std::move(next);
+	}
+};
+
+} // namespace maxcut
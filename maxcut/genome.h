@@ -0,0 +1,212 @@
+#pragma once
+// Packed chromosome: bit i is the side (0/1) of vertex i
+// Operators work on whole 64-bit words where they can; the bits past size() are always kept 0.
+// * BitGenome: any length, words on the heap
+// * FixedGenome<W>: at most 64 W genes in an inline std::array, for small graphs (see dispatch_genome)
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace maxcut {
+
+using Rng = std::mt19937_64; // random engine used by every engine and operator
+
+// Number of set bits in a word
+inline int popcount64(std::uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+	return int(__popcnt64(x));
+#elif defined(__GNUC__)
+	return __builtin_popcountll(x);
+#else
+	x = x - ((x >> 1) & 0x5555555555555555ULL);
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return int((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+class BitGenome {
+private:
+	std::vector<std::uint64_t> bits; // packed genes
+	std::size_t n = 0; // number of genes
+
+public:
+	BitGenome() = default;
+	explicit BitGenome(std::size_t n) : bits((n + 63) / 64, 0), n(n) {}
+
+	// Number of genes
+	std::size_t size() const { return n; }
+	// Number of 64-bit words
+	std::size_t word_count() const { return bits.size(); }
+	std::uint64_t word(std::size_t i) const { return bits[i]; }
+	void set_word(std::size_t i, std::uint64_t w) { bits[i] = w; }
+	const std::uint64_t* data() const { return bits.data(); }
+	// Mask of the valid bits in the last word
+	std::uint64_t tail_mask() const { return (n % 64) ? ((std::uint64_t(1) << (n % 64)) - 1) : ~std::uint64_t(0); }
+	// Clear the bits past size()
+	void mask_tail() {
+		if (!bits.empty())
+			bits.back() &= tail_mask();
+	}
+
+	bool get(std::size_t i) const { return (bits[i >> 6] >> (i & 63)) & 1; }
+	void set(std::size_t i, bool b) {
+		std::uint64_t m = std::uint64_t(1) << (i & 63);
+		bits[i >> 6] = b ? (bits[i >> 6] | m) : (bits[i >> 6] & ~m);
+	}
+	void flip(std::size_t i) { bits[i >> 6] ^= std::uint64_t(1) << (i & 63); }
+
+	// Uniform random partition
+	void randomize(Rng& rng) {
+		for (auto& w : bits)
+			w = rng();
+		mask_tail();
+	}
+
+	// Number of genes set to 1
+	std::size_t count() const {
+		std::size_t c = 0;
+		for (auto w : bits)
+			c += popcount64(w);
+		return c;
+	}
+
+	bool operator==(const BitGenome& other) const { return n == other.n && bits == other.bits; }
+	bool operator!=(const BitGenome& other) const { return !(*this == other); }
+};
+
+template <std::size_t W>
+class FixedGenome {
+private:
+	std::array<std::uint64_t, W> bits{}; // packed genes, words past the last gene stay 0
+	std::size_t n = 0; // number of genes, at most 64 W
+
+public:
+	static constexpr std::size_t capacity = 64 * W; // largest supported length
+
+	FixedGenome() = default;
+	explicit FixedGenome(std::size_t n) : n(n) {}
+
+	std::size_t size() const { return n; }
+	// Always W, so word loops have a compile-time trip count and unroll
+	static constexpr std::size_t word_count() { return W; }
+	std::uint64_t word(std::size_t i) const { return bits[i]; }
+	void set_word(std::size_t i, std::uint64_t w) { bits[i] = w; }
+	const std::uint64_t* data() const { return bits.data(); }
+	// Clear every bit at or past size()
+	void mask_tail() {
+		for (std::size_t i = 0; i < W; i++) {
+			std::size_t lo = 64 * i;
+			if (lo >= n)
+				bits[i] = 0;
+			else if (n - lo < 64)
+				bits[i] &= (std::uint64_t(1) << (n - lo)) - 1;
+		}
+	}
+
+	bool get(std::size_t i) const { return (bits[i >> 6] >> (i & 63)) & 1; }
+	void set(std::size_t i, bool b) {
+		std::uint64_t m = std::uint64_t(1) << (i & 63);
+		bits[i >> 6] = b ? (bits[i >> 6] | m) : (bits[i >> 6] & ~m);
+	}
+	void flip(std::size_t i) { bits[i >> 6] ^= std::uint64_t(1) << (i & 63); }
+
+	void randomize(Rng& rng) {
+		for (auto& w : bits)
+			w = rng();
+		mask_tail();
+	}
+
+	std::size_t count() const {
+		std::size_t c = 0;
+		for (auto w : bits)
+			c += popcount64(w);
+		return c;
+	}
+
+	bool operator==(const FixedGenome& other) const { return n == other.n && bits == other.bits; }
+	bool operator!=(const FixedGenome& other) const { return !(*this == other); }
+};
+
+// Type carried by dispatch_genome()
+template <class Genome>
+struct GenomeTag {
+	using type = Genome;
+};
+
+// Call f(GenomeTag<G>{}) with the smallest size class that holds n genes:
+// FixedGenome<1|2|4|8> up to 64/128/256/512 vertices, BitGenome above that
+template <class F>
+decltype(auto) dispatch_genome(std::size_t n, F&& f) {
+	if (n <= FixedGenome<1>::capacity)
+		return f(GenomeTag<FixedGenome<1>>{});
+	if (n <= FixedGenome<2>::capacity)
+		return f(GenomeTag<FixedGenome<2>>{});
+	if (n <= FixedGenome<4>::capacity)
+		return f(GenomeTag<FixedGenome<4>>{});
+	if (n <= FixedGenome<8>::capacity)
+		return f(GenomeTag<FixedGenome<8>>{});
+	return f(GenomeTag<BitGenome>{});
+}
+
+// Number of differing bits of a[0 .. words) and b[0 .. words).
+// With AVX2, 4 words per step: nibble popcounts by table lookup (vpshufb), summed per word with vpsadbw.
+inline std::size_t hamming_words(const std::uint64_t* a, const std::uint64_t* b, std::size_t words) {
+	std::size_t d = 0, i = 0;
+#ifdef __AVX2__
+	if (words >= 8) {
+		const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+			0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		const __m256i low = _mm256_set1_epi8(0x0f);
+		__m256i sum = _mm256_setzero_si256();
+		for (; i + 4 <= words; i += 4) {
+			__m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+				_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+			__m256i count = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(x, low)),
+				_mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(x, 4), low)));
+			sum = _mm256_add_epi64(sum, _mm256_sad_epu8(count, _mm256_setzero_si256()));
+		}
+		alignas(32) std::uint64_t lanes[4];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(lanes), sum);
+		d = std::size_t(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+	}
+#endif
+	for (; i < words; i++)
+		d += popcount64(a[i] ^ b[i]);
+	return d;
+}
+
+// Hamming distance between two genomes of the same length
+template <class Genome>
+std::size_t hamming(const Genome& a, const Genome& b) {
+	return hamming_words(a.data(), b.data(), a.word_count());
+}
+
+// Distance between the cuts of two genomes: a genome and its complement are the same cut
+template <class Genome>
+std::size_t cut_distance(const Genome& a, const Genome& b) {
+	std::size_t d = hamming(a, b);
+	return std::min(d, a.size() - d);
+}
+
+// A genome and its complement are the same cut: keep the form with gene 0 unset, by inverting every word
+template <class Genome>
+void canonicalize(Genome& g) {
+	if (g.size() == 0 || !g.get(0))
+		return;
+	for (std::size_t i = 0; i < g.word_count(); i++)
+		g.set_word(i, ~g.word(i));
+	g.mask_tail();
+}
+
+} // namespace maxcut
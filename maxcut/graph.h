@@ -0,0 +1,111 @@
+#pragma once
+// Problem graph shared by the engines
+// * Vertices are 0-based inside the engines; the input and output files are 1-based.
+// * Every undirected edge is stored once in edges, and twice in the CSR adjacency (offset/adj/adj_w).
+#include <cstddef>
+#include <fstream>
+#include <istream>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace maxcut {
+
+struct Edge {
+	int u; // endpoint (0-based)
+	int v; // endpoint (0-based)
+	int w; // weight
+};
+
+// Append edge (u, v) of weight w to edges. Edge weights are ints; a sum beyond their range (merged parallel
+// edges, contractions) is appended as parallel edges that add up to it, which leaves every cut unchanged.
+inline void append_edge(std::vector<Edge>& edges, int u, int v, long long w) {
+	const long long most = std::numeric_limits<int>::max();
+	for (; w > most || w < -most; w -= w > 0 ? most : -most)
+		edges.push_back(Edge{ u, v, int(w > 0 ? most : -most) });
+	if (w != 0)
+		edges.push_back(Edge{ u, v, int(w) });
+}
+
+class Graph {
+public:
+	int n = 0; // number of vertices
+	std::vector<Edge> edges; // each undirected edge once
+	std::vector<int> offset; // CSR: neighbours of v are adj[offset[v]] .. adj[offset[v + 1] - 1]
+	std::vector<int> adj; // CSR neighbour
+	std::vector<int> adj_w; // CSR weight, parallel to adj
+
+public:
+	Graph() = default;
+	Graph(int n, std::vector<Edge> edges) {
+		this->n = n;
+		this->edges = std::move(edges);
+		build();
+	}
+
+	// Number of vertices
+	int size() const { return n; }
+	// Number of undirected edges
+	std::size_t edge_count() const { return edges.size(); }
+	// Degree of v
+	int degree(int v) const { return offset[v + 1] - offset[v]; }
+
+	// Add an undirected edge given with 1-based vertices: out-of-range vertices and self loops are dropped
+	bool add_undir(int from, int to, int w) {
+		if (from <= 0 || from > n || to <= 0 || to > n || from == to)
+			return false;
+		edges.push_back(Edge{ from - 1, to - 1, w });
+		return true;
+	}
+
+	// Build the CSR adjacency from edges (counting sort by endpoint)
+	void build() {
+		offset.assign(std::size_t(n) + 1, 0);
+		for (const Edge& e : edges) {
+			offset[e.u + 1]++;
+			offset[e.v + 1]++;
+		}
+		for (int v = 0; v < n; v++)
+			offset[v + 1] += offset[v];
+		adj.resize(2 * edges.size());
+		adj_w.resize(2 * edges.size());
+		std::vector<int> pos(offset.begin(), offset.end() - 1);
+		for (const Edge& e : edges) {
+			adj[pos[e.u]] = e.v;
+			adj_w[pos[e.u]++] = e.w;
+			adj[pos[e.v]] = e.u;
+			adj_w[pos[e.v]++] = e.w;
+		}
+	}
+
+	// Sum of all edge weights
+	long long total_weight() const {
+		long long sum = 0;
+		for (const Edge& e : edges)
+			sum += e.w;
+		return sum;
+	}
+};
+
+// Read "V E" followed by E lines of "u v w"; false when the header is missing
+inline bool read_graph(std::istream& input, Graph& graph) {
+	int v = 0, e = 0;
+	if (!(input >> v >> e) || v < 0 || e < 0)
+		return false;
+	graph = Graph();
+	graph.n = v;
+	graph.edges.reserve(std::size_t(e));
+	int from, to, w;
+	for (int i = 0; i < e && (input >> from >> to >> w); i++)
+		graph.add_undir(from, to, w);
+	graph.build();
+	return true;
+}
+
+// Read a graph file
+inline bool load_graph(const std::string& path, Graph& graph) {
+	std::ifstream input(path);
+	return input && read_graph(input, graph);
+}
+
+} // namespace maxcut
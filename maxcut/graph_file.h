@@ -0,0 +1,271 @@
+#pragma once
+// Binary graph files: parse once, map many times
+// Layout (native byte order, checked through a marker in the header), every section 64-byte aligned:
+//   GraphFileHeader
+//   edge_u  int32 [E]       endpoints of each undirected edge, 0-based, as in Graph::edges
+//   edge_v  int32 [E]
+//   edge_w  W     [E]       weights; W is int8, int16 or int32 (the narrowest that holds them by default)
+//   offset  int32 [V + 1]   CSR, as in Graph
+//   adj     int32 [2E]
+//   adj_w   W     [2E]
+// hash is content_hash() of everything after the header. GraphFile maps a file read-only and shares its
+// pages with every other process mapping it; the arrays are used in place (zero-copy), and to_graph() turns
+// them into a Graph for the engines with bulk copies instead of parsing text and sorting adjacency again.
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "graph.h"
+#include "loader.h"
+#include "weights.h"
+
+namespace maxcut {
+
+struct GraphFileHeader {
+	char magic[8]; // "MAXCUTG1"
+	std::uint32_t byte_order; // 0x01020304 as written
+	std::uint32_t weight_bytes; // 1, 2 or 4
+	std::uint64_t vertices;
+	std::uint64_t edges;
+	std::uint64_t hash; // content_hash() of the sections
+	std::uint64_t reserved[3];
+};
+
+constexpr char graph_file_magic[8] = { 'M', 'A', 'X', 'C', 'U', 'T', 'G', '1' };
+
+// 64-bit hash of a byte range, a word at a time
+inline std::uint64_t content_hash(const char* data, std::size_t size) {
+	std::uint64_t h = 0x243F6A8885A308D3ULL ^ size;
+	std::size_t i = 0;
+	for (; i + 8 <= size; i += 8) {
+		std::uint64_t w;
+		std::memcpy(&w, data + i, 8);
+		h = (h ^ w) * 0x9E3779B97F4A7C15ULL;
+		h ^= h >> 29;
+	}
+	std::uint64_t tail = 0;
+	std::memcpy(&tail, data + i, size - i);
+	h = (h ^ tail) * 0x9E3779B97F4A7C15ULL;
+	return h ^ (h >> 32);
+}
+
+// Byte offsets of the sections for a graph of this shape; the last entry is the file size
+inline std::vector<std::size_t> graph_file_sections(std::size_t vertices, std::size_t edges, std::size_t weight_bytes) {
+	std::size_t sizes[6] = { 4 * edges, 4 * edges, weight_bytes * edges, 4 * (vertices + 1), 8 * edges, 2 * weight_bytes * edges };
+	std::vector<std::size_t> at(7);
+	at[0] = (sizeof(GraphFileHeader) + 63) / 64 * 64;
+	for (int s = 0; s < 6; s++)
+		at[std::size_t(s) + 1] = (at[std::size_t(s)] + sizes[s] + 63) / 64 * 64;
+	return at;
+}
+
+// Narrowest weight width (1, 2 or 4 bytes) holding every weight of graph
+inline std::size_t narrowest_weight_bytes(const Graph& graph) {
+	return std::max<std::size_t>(1, weight_bytes(weight_kind(graph.edges)));
+}
+
+// Write graph to path; weight_bytes 0 picks the narrowest width. False when the weights do not fit it or
+// the file cannot be written.
+inline bool write_graph_file(const std::string& path, const Graph& graph, std::size_t weight_bytes = 0) {
+	std::size_t need = narrowest_weight_bytes(graph);
+	if (weight_bytes == 0)
+		weight_bytes = need;
+	if ((weight_bytes != 1 && weight_bytes != 2 && weight_bytes != 4) || weight_bytes < need)
+		return false;
+	std::size_t n = std::size_t(graph.size()), m = graph.edge_count();
+	std::vector<std::size_t> at = graph_file_sections(n, m, weight_bytes);
+	std::vector<char> image(at[6], 0);
+	auto put_weights = [&](std::size_t section, const int* w, std::size_t count) {
+		char* out = image.data() + at[section];
+		for (std::size_t i = 0; i < count; i++) {
+			if (weight_bytes == 1)
+				out[i] = char(std::int8_t(w[i]));
+			else if (weight_bytes == 2) {
+				std::int16_t x = std::int16_t(w[i]);
+				std::memcpy(out + 2 * i, &x, 2);
+			}
+			else
+				std::memcpy(out + 4 * i, &w[i], 4);
+		}
+	};
+	std::vector<int> column(m);
+	for (std::size_t i = 0; i < m; i++)
+		column[i] = graph.edges[i].u;
+	std::memcpy(image.data() + at[0], column.data(), 4 * m);
+	for (std::size_t i = 0; i < m; i++)
+		column[i] = graph.edges[i].v;
+	std::memcpy(image.data() + at[1], column.data(), 4 * m);
+	for (std::size_t i = 0; i < m; i++)
+		column[i] = graph.edges[i].w;
+	put_weights(2, column.data(), m);
+	std::memcpy(image.data() + at[3], graph.offset.data(), 4 * (n + 1));
+	std::memcpy(image.data() + at[4], graph.adj.data(), 8 * m);
+	put_weights(5, graph.adj_w.data(), 2 * m);
+
+	GraphFileHeader header{};
+	std::memcpy(header.magic, graph_file_magic, 8);
+	header.byte_order = 0x01020304;
+	header.weight_bytes = std::uint32_t(weight_bytes);
+	header.vertices = n;
+	header.edges = m;
+	header.hash = content_hash(image.data() + at[0], at[6] - at[0]);
+	std::memcpy(image.data(), &header, sizeof(header));
+
+	std::FILE* f = std::fopen(path.c_str(), "wb");
+	if (f == nullptr)
+		return false;
+	bool ok = std::fwrite(image.data(), 1, image.size(), f) == image.size();
+	return std::fclose(f) == 0 && ok;
+}
+
+// Whether the bytes start like a graph file
+inline bool is_graph_file(const char* data, std::size_t size) {
+	return size >= sizeof(GraphFileHeader) && std::memcmp(data, graph_file_magic, 8) == 0;
+}
+
+// A mapped graph file, read in place
+class GraphFile {
+private:
+	MappedFile file;
+	GraphFileHeader header{};
+	std::vector<std::size_t> at; // section offsets
+
+public:
+	// Map path; false when it is not a well-formed graph file (or, with verify, its hash does not match). Every
+	// index is range-checked on open, so a file that opens is safe to read whatever its hash.
+	bool open(const std::string& path, bool verify = false) {
+		return file.open(path) && attach(verify);
+	}
+
+	int size() const { return int(header.vertices); }
+	std::size_t edge_count() const { return std::size_t(header.edges); }
+	std::size_t weight_bytes() const { return header.weight_bytes; }
+	std::uint64_t hash() const { return header.hash; }
+	// The bytes as mapped (or read), also after an open() that failed on them
+	const MappedFile& mapping() const { return file; }
+
+	const std::int32_t* edge_u() const { return section<std::int32_t>(0); }
+	const std::int32_t* edge_v() const { return section<std::int32_t>(1); }
+	const std::int32_t* offset() const { return section<std::int32_t>(3); }
+	const std::int32_t* adj() const { return section<std::int32_t>(4); }
+	// Weight of edge i / of adjacency entry k, whatever the stored width
+	int edge_weight(std::size_t i) const { return weight_at(2, i); }
+	int adj_weight(std::size_t k) const { return weight_at(5, k); }
+	// Raw weight sections, weight_bytes() wide
+	const void* edge_weights() const { return file.data() + at[2]; }
+	const void* adj_weights() const { return file.data() + at[5]; }
+
+	// Paging hints for the edge list rows [begin, end) (edge_u, edge_v and the weights): read ahead, or drop
+	void prefetch_edges(std::size_t begin, std::size_t end) const {
+		for (int s = 0; s < 3; s++)
+			file.will_need(at[std::size_t(s)] + row_bytes(s) * begin, row_bytes(s) * (end - begin));
+	}
+	void release_edges(std::size_t begin, std::size_t end) const {
+		for (int s = 0; s < 3; s++)
+			file.done_with(at[std::size_t(s)] + row_bytes(s) * begin, row_bytes(s) * (end - begin));
+	}
+
+	// Recompute the hash of the sections and compare it with the header's
+	bool verify() const { return content_hash(file.data() + at[0], at[6] - at[0]) == header.hash; }
+
+	// Copy into a Graph for the engines
+	void to_graph(Graph& graph) const {
+		std::size_t n = std::size_t(header.vertices), m = std::size_t(header.edges);
+		graph = Graph();
+		graph.n = int(n);
+		graph.edges.resize(m);
+		const std::int32_t* u = edge_u();
+		const std::int32_t* v = edge_v();
+		for (std::size_t i = 0; i < m; i++)
+			graph.edges[i] = Edge{ u[i], v[i], edge_weight(i) };
+		graph.offset.assign(offset(), offset() + n + 1);
+		graph.adj.assign(adj(), adj() + 2 * m);
+		graph.adj_w.resize(2 * m);
+		widen(5, graph.adj_w.data(), 2 * m);
+	}
+
+private:
+	template <class T>
+	const T* section(int s) const { return reinterpret_cast<const T*>(file.data() + at[std::size_t(s)]); }
+
+	std::size_t row_bytes(int s) const { return s == 2 ? std::size_t(header.weight_bytes) : 4; }
+
+	int weight_at(int s, std::size_t i) const {
+		const char* p = file.data() + at[std::size_t(s)];
+		if (header.weight_bytes == 1)
+			return std::int8_t(p[i]);
+		if (header.weight_bytes == 2) {
+			std::int16_t x;
+			std::memcpy(&x, p + 2 * i, 2);
+			return x;
+		}
+		std::int32_t x;
+		std::memcpy(&x, p + 4 * i, 4);
+		return x;
+	}
+
+	void widen(int s, int* out, std::size_t count) const {
+		if (header.weight_bytes == 4) {
+			std::memcpy(out, file.data() + at[std::size_t(s)], 4 * count);
+			return;
+		}
+		for (std::size_t i = 0; i < count; i++)
+			out[i] = weight_at(s, i);
+	}
+
+	bool attach(bool check) {
+		if (!is_graph_file(file.data(), file.size()))
+			return false;
+		std::memcpy(&header, file.data(), sizeof(header));
+		if (header.byte_order != 0x01020304 || (header.weight_bytes != 1 && header.weight_bytes != 2 && header.weight_bytes != 4))
+			return false;
+		// counts the int32 arrays (and Graph) can index, before any size is computed from them
+		if (header.vertices > std::uint64_t(INT_MAX) || header.edges > std::uint64_t(INT_MAX / 2))
+			return false;
+		at = graph_file_sections(std::size_t(header.vertices), std::size_t(header.edges), header.weight_bytes);
+		if (file.size() < at[6])
+			return false;
+		return well_formed() && (!check || verify());
+	}
+
+	// Every index the readers follow is in range: endpoints below V and distinct, offsets rising from 0 to 2E,
+	// neighbours below V. One pass over the index sections, so a damaged file is refused instead of crashing
+	// an engine; the hash (verify) is still what catches wrong weights.
+	bool well_formed() const {
+		std::uint32_t n = std::uint32_t(header.vertices);
+		std::size_t m = std::size_t(header.edges);
+		const std::int32_t* u = edge_u();
+		const std::int32_t* v = edge_v();
+		bool bad = false;
+		for (std::size_t i = 0; i < m; i++)
+			bad |= std::uint32_t(u[i]) >= n || std::uint32_t(v[i]) >= n || u[i] == v[i];
+		const std::int32_t* off = offset();
+		bad |= off[0] != 0 || std::size_t(off[n]) != 2 * m;
+		for (std::size_t k = 0; k < n; k++)
+			bad |= off[k] > off[k + 1];
+		const std::int32_t* a = adj();
+		for (std::size_t k = 0; k < 2 * m; k++)
+			bad |= std::uint32_t(a[k]) >= n;
+		return !bad;
+	}
+};
+
+// Load either a graph file or "V E" + "u v w" text. path is opened once and the bytes read are parsed as
+// whichever they turn out to be, so a pipe or a FIFO works as well as a file.
+inline bool load_graph_any(const std::string& path, Graph& graph, unsigned threads = 0) {
+	GraphFile file;
+	if (file.open(path)) {
+		file.to_graph(graph);
+		return true;
+	}
+	const MappedFile& bytes = file.mapping();
+	if (bytes.data() == nullptr || is_graph_file(bytes.data(), bytes.size())) // unreadable, or a malformed graph file
+		return false;
+	return parse_graph(bytes.data(), bytes.data() + bytes.size(), graph, threads);
+}
+
+} // namespace maxcut
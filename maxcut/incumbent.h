@@ -0,0 +1,218 @@
+#pragma once
+// Best-so-far solution (incumbent) and anytime output
+// * Every improving offer() rewrites the output file (maxcut.out) atomically: write a temp file, then rename.
+// * The output text is formatted up front into one of two buffers, so a signal handler can read it safely: the
+//   handler claims the buffer it writes out, and offer() never reformats a claimed buffer.
+// * With install_stop_handlers(&incumbent), SIGINT/SIGTERM write the best solution and exit immediately; with
+//   no solution yet (the input still loading, say) they exit all the same.
+// * When the engines solve a reduced graph (kernel.h), set_lift() maps their partitions back to the input.
+// * With set_target(upper bound), an offer reaching the bound stops every engine (g_optimum_reached).
+#include <atomic>
+#include <charconv>
+#include <climits>
+#include <csignal>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "deadline.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace maxcut {
+
+class Incumbent {
+private:
+	std::string path; // output file
+	std::string tmp_path; // temp file for normal writes
+	std::string sig_path; // temp file for the signal handler
+	std::atomic<long long> best_cost{ LLONG_MIN }; // best cost so far
+	std::atomic<long long> target{ LLONG_MAX }; // no cost can exceed this
+	std::mutex lock; // serialises concurrent offer()
+	std::vector<char> text[2]; // double-buffered output text
+	std::atomic<int> active{ -1 }; // index of the complete buffer, -1 before the first solution
+	mutable std::atomic<int> reading{ -1 }; // index of the buffer the signal handler is writing out, -1 for none
+	std::function<void(std::vector<std::uint8_t>&)> lift; // reduced partition -> input partition, empty for none
+	long long lift_offset = 0; // input cost - reduced cost
+	std::vector<std::uint8_t> lifted; // scratch for lift
+
+	// Write then rename: the output file always holds a complete solution
+	void write_file(const std::vector<char>& buf) {
+		{
+			std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+			out.write(buf.data(), std::streamsize(buf.size()));
+			if (!out)
+				return;
+		}
+#ifdef _WIN32
+		MoveFileExA(tmp_path.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING);
+#else
+		std::rename(tmp_path.c_str(), path.c_str());
+#endif
+	}
+
+	// Output text: the 1-based vertices with in_set(i), space separated, one line
+	template <class InSet>
+	static void format(std::vector<char>& buf, std::size_t n, InSet in_set) {
+		char num[24];
+		buf.clear();
+		for (std::size_t i = 0; i < n; i++) {
+			if (!in_set(i))
+				continue;
+			char* last = std::to_chars(num, num + sizeof(num), i + 1).ptr;
+			buf.insert(buf.end(), num, last);
+			buf.push_back(' ');
+		}
+		buf.push_back('\n');
+	}
+
+public:
+	explicit Incumbent(const std::string& path = "maxcut.out") {
+		this->path = path;
+		this->tmp_path = path + ".tmp";
+		this->sig_path = path + ".sig";
+	}
+	Incumbent(const Incumbent&) = delete;
+	Incumbent& operator=(const Incumbent&) = delete;
+
+	// Offered solutions belong to a reduced graph: lift(sides) extends a 0 / 1 partition of it to the input's
+	// vertices in place, and offset is added to every offered cost. Call before any offer().
+	void set_lift(std::function<void(std::vector<std::uint8_t>&)> lift, long long offset) {
+		this->lift = std::move(lift);
+		this->lift_offset = offset;
+	}
+
+	// No solution can cost more than bound (a cost as offered, before the lift offset): reaching it sets
+	// g_optimum_reached. Call after set_lift().
+	void set_target(long long bound) {
+		bound += lift_offset;
+		target.store(bound, std::memory_order_relaxed);
+		if (best() >= bound)
+			g_optimum_reached.store(true, std::memory_order_relaxed);
+	}
+	// Whether the best cost has reached the target, so it is optimal
+	bool optimal() const { return best() >= target.load(std::memory_order_relaxed); }
+
+	// Best cost, LLONG_MIN before the first solution
+	long long best() const { return best_cost.load(std::memory_order_relaxed); }
+	// Whether any solution has been offered
+	bool has_solution() const { return active.load(std::memory_order_acquire) >= 0; }
+
+	// Offer a solution; kept (and written out) only if it beats the best cost.
+	// in_set(i) is true when 0-based vertex i belongs to the printed side.
+	template <class InSet>
+	bool offer(long long cost, std::size_t n, InSet in_set) {
+		cost += lift_offset;
+		if (cost <= best_cost.load(std::memory_order_relaxed)) // the common case
+			return false;
+		std::lock_guard<std::mutex> guard(lock);
+		if (cost <= best_cost.load(std::memory_order_relaxed))
+			return false;
+		best_cost.store(cost, std::memory_order_relaxed);
+		if (cost >= target.load(std::memory_order_relaxed))
+			g_optimum_reached.store(true, std::memory_order_relaxed);
+
+		int next = (active.load(std::memory_order_relaxed) == 0 ? 1 : 0); // the buffer not being published
+		// a handler running on another thread may have claimed it before the last switch; it either exits the
+		// process or lets go (a handler on this thread returns before offer() resumes)
+		while (reading.load() == next)
+			std::this_thread::yield();
+		std::vector<char>& buf = text[next];
+		if (lift) {
+			lifted.resize(n);
+			for (std::size_t i = 0; i < n; i++)
+				lifted[i] = in_set(i) ? 1 : 0;
+			lift(lifted);
+			format(buf, lifted.size(), [&](std::size_t i) { return lifted[i] == lifted[0]; });
+		}
+		else
+			format(buf, n, in_set);
+		active.store(next);
+
+		write_file(buf);
+		return true;
+	}
+
+	// Rewrite the file with the current solution (an empty line if there is none)
+	void flush() {
+		std::lock_guard<std::mutex> guard(lock);
+		int cur = active.load(std::memory_order_acquire);
+		write_file(cur >= 0 ? text[cur] : std::vector<char>{ '\n' });
+	}
+
+	// Signal handler only: async-signal-safe calls, false when there is nothing to write
+	bool flush_from_signal() const noexcept {
+#ifdef _WIN32
+		return false; // on Windows offer() has already written the file; only the flag is set
+#else
+		// claim the published buffer, then make sure it is still the published one: offer() checks the claim
+		// before it reformats a buffer, and both sides use sequentially consistent order
+		int cur = active.load();
+		for (;;) {
+			if (cur < 0)
+				return false;
+			reading.store(cur);
+			int now = active.load();
+			if (now == cur)
+				break;
+			cur = now;
+		}
+		const std::vector<char>& buf = text[cur];
+		int fd = open(sig_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0) {
+			reading.store(-1);
+			return false;
+		}
+		std::size_t done = 0;
+		while (done < buf.size()) {
+			ssize_t w = write(fd, buf.data() + done, buf.size() - done);
+			if (w <= 0)
+				break;
+			done += std::size_t(w);
+		}
+		close(fd);
+		bool written = done == buf.size() && rename(sig_path.c_str(), path.c_str()) == 0;
+		if (!written)
+			reading.store(-1);
+		return written;
+#endif
+	}
+};
+
+// Incumbent registered for anytime mode, used by the signal handler
+inline std::atomic<Incumbent*> g_anytime{ nullptr };
+
+// SIGINT/SIGTERM handler: expire every Deadline; in anytime mode write the best solution and exit. Without a
+// solution there is nothing to write and no engine that would see the Deadline yet (the loader never looks),
+// so exit at once; only a failed write leaves the stop to the engines and the final flush.
+inline void on_stop_signal(int sig) {
+	g_stop_signal = 1;
+	Incumbent* incumbent = g_anytime.load();
+	if (incumbent != nullptr && (incumbent->flush_from_signal() || !incumbent->has_solution()))
+		std::_Exit(128 + sig);
+}
+
+// Install the stop handlers; passing an incumbent enables anytime mode
+inline void install_stop_handlers(Incumbent* anytime = nullptr) {
+	g_anytime.store(anytime);
+	std::signal(SIGINT, on_stop_signal);
+	std::signal(SIGTERM, on_stop_signal);
+}
+
+} // namespace maxcut
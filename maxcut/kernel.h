@@ -0,0 +1,272 @@
+#pragma once
+// Kernelization: safe max-cut reductions applied before any engine starts
+// Rules, repeated until none applies:
+// * parallel edges are merged into one edge with the summed weight (zero-weight edges are dropped)
+// * a vertex without edges is removed; its side does not matter
+// * a vertex v whose edge to u carries at least half of v's total |weight| is contracted into u, on the
+//   opposite side when w(u, v) > 0 and on the same side otherwise. Whatever the other sides are, putting v
+//   there loses nothing: flipping v away would give up |w(u, v)| and gain at most the rest. A degree-1
+//   vertex is the simplest case. As in multilevel.h, v's other edges move to u with their sign flipped when
+//   v sits opposite u, plus a constant, so (input cut) = constant + (kernel cut) exactly.
+// Every removal is recorded, and lift() replays them backwards to extend a kernel partition to the input.
+// The work stays near-linear on hubs: each vertex keeps its total |weight| exactly and its heaviest |weight|
+// as an upper bound, so a vertex is rescanned (and re-queued) only when 2 * heaviest >= total can hold; an
+// edge that goes away is only zeroed in place, and a new one is appended to a short unsorted tail that is
+// merged into the sorted list once it outgrows the square root of the list. reduce() stops early, with a
+// valid partial kernel, when its deadline passes.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "deadline.h"
+#include "graph.h"
+
+namespace maxcut {
+
+class Kernel {
+private:
+	struct Removal {
+		int v; // removed vertex
+		int anchor; // vertex it was contracted into, -1 when it had no edges
+		std::uint8_t orient; // side(v) = side(anchor) ^ orient
+	};
+	// (neighbour, weight): sorted by neighbour up to `sorted`, then unsorted; weight 0 marks a removed edge
+	struct Adjacency {
+		std::vector<std::pair<int, long long>> entries;
+		std::size_t sorted = 0;
+		int degree = 0; // entries with a nonzero weight
+		long long total = 0; // sum of their |weight|, exact
+		long long heaviest = 0; // their largest |weight|, or more
+	};
+
+	std::size_t input_vertices = 0, input_edges = 0;
+	std::vector<Removal> removals; // in the order applied
+	std::vector<int> original; // input vertex of each kernel vertex
+	long long offset = 0; // input cut = offset + kernel cut
+
+	// state of reduce()
+	std::vector<Adjacency> adj;
+	std::vector<std::uint8_t> alive, queued;
+	std::vector<int> work;
+
+public:
+	Graph graph; // the kernel
+
+	// Reduce input to graph; when deadline (if given) passes first, graph is the kernel reached so far
+	void reduce(const Graph& input, const Deadline* deadline = nullptr) {
+		// checked through a slice of its own: this pass calls expired() far more often than the engines that
+		// share deadline, and the clock-read stride it settles on must not carry over to them
+		bool timed = deadline != nullptr;
+		Deadline clock = timed ? deadline->slice(1) : Deadline();
+		std::size_t n = std::size_t(input.size());
+		input_vertices = n;
+		input_edges = input.edge_count();
+		removals.clear();
+		offset = 0;
+
+		adj.assign(n, Adjacency());
+		for (std::size_t v = 0; v < n; v++) {
+			if (timed && clock.expired())
+				return keep(input);
+			Adjacency& list = adj[v];
+			list.entries.reserve(std::size_t(input.degree(int(v))));
+			for (int k = input.offset[v]; k < input.offset[v + 1]; k++)
+				list.entries.push_back({ input.adj[std::size_t(k)], input.adj_w[std::size_t(k)] });
+			merge_parallel(list.entries);
+			list.sorted = list.entries.size();
+			list.degree = int(list.entries.size());
+			for (const auto& x : list.entries) {
+				long long a = x.second < 0 ? -x.second : x.second;
+				list.total += a;
+				list.heaviest = std::max(list.heaviest, a);
+			}
+		}
+
+		alive.assign(n, 1);
+		queued.assign(n, 1);
+		work.resize(n);
+		for (std::size_t v = 0; v < n; v++)
+			work[v] = int(n - 1 - v); // popped from the back: vertex 0 first
+		while (!work.empty()) {
+			if (timed && clock.expired())
+				break;
+			int v = work.back();
+			work.pop_back();
+			queued[v] = 0;
+			if (!alive[v])
+				continue;
+			Adjacency& list = adj[std::size_t(v)];
+			if (list.degree == 0) {
+				alive[v] = 0;
+				removals.push_back(Removal{ v, -1, 0 });
+				continue;
+			}
+			if (!may_reduce(v))
+				continue;
+			// the bound passed: find the heaviest edge itself
+			long long most = 0;
+			int u = -1;
+			for (const auto& x : list.entries) {
+				long long a = x.second < 0 ? -x.second : x.second;
+				if (a > most) {
+					most = a;
+					u = x.first;
+				}
+			}
+			list.heaviest = most;
+			if (2 * most < list.total)
+				continue;
+			contract(v, u);
+		}
+
+		if (removals.empty())
+			return keep(input);
+
+		// renumber the survivors
+		std::vector<int> index(n, -1);
+		original.clear();
+		for (std::size_t v = 0; v < n; v++) {
+			if (alive[v]) {
+				index[v] = int(original.size());
+				original.push_back(int(v));
+			}
+		}
+		std::vector<Edge> edges;
+		for (int v : original) {
+			Adjacency& list = adj[std::size_t(v)];
+			normalize(list);
+			for (const auto& x : list.entries) {
+				if (x.first > v) // kernel weights are sums and may leave int range: append_edge splits them
+					append_edge(edges, index[v], index[x.first], x.second);
+			}
+		}
+		adj = std::vector<Adjacency>();
+		graph = Graph(int(original.size()), std::move(edges));
+	}
+
+	// Input cut = constant() + kernel cut
+	long long constant() const { return offset; }
+	std::size_t removed_vertices() const { return input_vertices - std::size_t(graph.size()); }
+	std::size_t removed_edges() const { return input_edges - graph.edge_count(); }
+	// Kernel vertices per input vertex, 1 when nothing was reduced
+	double ratio() const { return input_vertices ? double(graph.size()) / double(input_vertices) : 1.0; }
+
+	// Extend a kernel partition (0 / 1 per kernel vertex) to the input's vertices, in place
+	void lift(std::vector<std::uint8_t>& sides) const {
+		std::vector<std::uint8_t> full(input_vertices, 0);
+		for (std::size_t k = 0; k < original.size() && k < sides.size(); k++)
+			full[std::size_t(original[k])] = sides[k];
+		for (std::size_t i = removals.size(); i-- > 0;) {
+			const Removal& r = removals[i];
+			full[std::size_t(r.v)] = r.anchor < 0 ? 0 : std::uint8_t(full[std::size_t(r.anchor)] ^ r.orient);
+		}
+		sides.swap(full);
+	}
+
+private:
+	// Nothing removed: the kernel is the input itself
+	void keep(const Graph& input) {
+		adj = std::vector<Adjacency>();
+		removals.clear();
+		original.resize(input_vertices);
+		for (std::size_t v = 0; v < input_vertices; v++)
+			original[v] = int(v);
+		graph = input;
+	}
+
+	static bool by_neighbour(const std::pair<int, long long>& a, const std::pair<int, long long>& b) { return a.first < b.first; }
+
+	// Sort by neighbour, sum duplicates, drop zeros
+	static void merge_parallel(std::vector<std::pair<int, long long>>& list) {
+		std::sort(list.begin(), list.end(), by_neighbour);
+		std::size_t out = 0;
+		for (std::size_t i = 0; i < list.size();) {
+			std::size_t j = i;
+			long long w = 0;
+			for (; j < list.size() && list[j].first == list[i].first; j++)
+				w += list[j].second;
+			if (w != 0)
+				list[out++] = { list[i].first, w };
+			i = j;
+		}
+		list.resize(out);
+	}
+
+	// Merge the tail into the sorted part and drop the removed edges
+	static void normalize(Adjacency& list) {
+		auto& e = list.entries;
+		std::sort(e.begin() + std::ptrdiff_t(list.sorted), e.end(), by_neighbour);
+		std::inplace_merge(e.begin(), e.begin() + std::ptrdiff_t(list.sorted), e.end(), by_neighbour);
+		e.erase(std::remove_if(e.begin(), e.end(), [](const std::pair<int, long long>& x) { return x.second == 0; }), e.end());
+		list.sorted = e.size();
+	}
+
+	// Whether v can pass 2 * heaviest >= total (or has no edges left), from the bound alone
+	bool may_reduce(int v) const {
+		const Adjacency& list = adj[std::size_t(v)];
+		return list.degree == 0 || 2 * list.heaviest >= list.total;
+	}
+
+	void enqueue(int v) {
+		if (alive[v] && !queued[v] && may_reduce(v)) {
+			queued[v] = 1;
+			work.push_back(v);
+		}
+	}
+
+	// Add d to w(a, b) in a's list (an absent edge weighs 0), keeping a's bookkeeping
+	void add_weight(int a, int b, long long d) {
+		Adjacency& list = adj[std::size_t(a)];
+		auto& e = list.entries;
+		auto end = e.begin() + std::ptrdiff_t(list.sorted);
+		auto it = std::lower_bound(e.begin(), end, std::pair<int, long long>(b, 0), by_neighbour);
+		if (it == end || it->first != b)
+			it = std::find_if(end, e.end(), [b](const std::pair<int, long long>& x) { return x.first == b; });
+		long long old = 0;
+		if (it != e.end()) {
+			old = it->second;
+			it->second += d;
+		}
+		else if (d != 0)
+			e.push_back({ b, d });
+		long long now = old + d, a_now = now < 0 ? -now : now;
+		list.total += a_now - (old < 0 ? -old : old);
+		list.heaviest = std::max(list.heaviest, a_now);
+		list.degree += (old == 0) - (now == 0);
+		std::size_t tail = e.size() - list.sorted;
+		if (tail > 16 && double(tail) * double(tail) > double(list.sorted))
+			normalize(list);
+	}
+
+	// Contract v into u; see the rules above
+	void contract(int v, int u) {
+		std::vector<std::pair<int, long long>> edges;
+		edges.swap(adj[std::size_t(v)].entries);
+		adj[std::size_t(v)] = Adjacency();
+		long long w_uv = 0;
+		for (const auto& x : edges) {
+			if (x.first == u)
+				w_uv = x.second;
+		}
+		bool opposite = w_uv > 0;
+		offset += opposite ? w_uv : 0;
+		add_weight(u, v, -w_uv);
+		for (const auto& x : edges) {
+			if (x.first == u || x.second == 0)
+				continue;
+			// edge (v, x) is cut iff side(u) ^ opposite != side(x)
+			long long w = opposite ? -x.second : x.second;
+			offset += opposite ? x.second : 0;
+			add_weight(x.first, v, -x.second);
+			add_weight(x.first, u, w);
+			add_weight(u, x.first, w);
+			enqueue(x.first);
+		}
+		alive[v] = 0;
+		removals.push_back(Removal{ v, u, std::uint8_t(opposite) });
+		enqueue(u);
+	}
+};
+
+} // namespace maxcut
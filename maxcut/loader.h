@@ -0,0 +1,422 @@
+#pragma once
+// Fast loading of large "V E" + "u v w" inputs
+// The file is memory-mapped (read into a buffer where mapping is unavailable) and the body after the header
+// is cut into chunks at line boundaries, one group per thread. Each thread scans its lines with a hand-rolled
+// integer scanner; a line holding three integers is an edge record, anything else (blank lines, comments) is
+// skipped. As with read_graph(), only the first E records count, and records with a vertex outside 1 .. V or
+// a self loop are dropped (Graph::add_undir). The CSR adjacency is then built by a parallel counting sort:
+// every thread counts the endpoints of its slice of the edges, the per-thread counts give each thread its
+// own write positions per vertex, and the threads scatter their slices. The result is laid out exactly as
+// Graph::build() would lay it out.
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "graph.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace maxcut {
+
+// A read-only view of a whole file: memory-mapped when possible, read into memory otherwise
+class MappedFile {
+private:
+	const char* bytes = nullptr;
+	std::size_t length = 0;
+	std::vector<char> copy; // the contents when the file could not be mapped
+#ifdef _WIN32
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = nullptr;
+#else
+	void* mapped = nullptr;
+#endif
+
+public:
+	MappedFile() = default;
+	explicit MappedFile(const std::string& path) { open(path); }
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile() { close(); }
+
+	// False when the file cannot be opened. A regular file is mapped; anything else (a pipe, a device) or a file
+	// that cannot be mapped is read into memory from the handle already open, since such a path may not be
+	// opened twice.
+	bool open(const std::string& path) {
+		close();
+#ifdef _WIN32
+		file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+		if (GetFileType(file) == FILE_TYPE_DISK) {
+			LARGE_INTEGER size;
+			if (!GetFileSizeEx(file, &size))
+				return false;
+			length = std::size_t(size.QuadPart);
+			if (length == 0)
+				return true;
+			mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping != nullptr)
+				bytes = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		}
+		return bytes != nullptr || read_all(file);
+#else
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+		struct stat st;
+		if (fstat(fd, &st) != 0) {
+			::close(fd);
+			return false;
+		}
+		bool regular = S_ISREG(st.st_mode); // only then is st_size the length: pipes and devices report 0
+		if (regular && st.st_size > 0) {
+			length = std::size_t(st.st_size);
+			mapped = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0); // read-only: pages shared with other processes
+			if (mapped == MAP_FAILED) {
+				mapped = nullptr;
+				length = 0;
+			}
+			else {
+				bytes = static_cast<const char*>(mapped);
+				madvise(mapped, length, MADV_SEQUENTIAL);
+			}
+		}
+		bool ok = bytes != nullptr || (regular && st.st_size == 0) || read_all(fd);
+		::close(fd);
+		return ok;
+#endif
+	}
+
+	void close() {
+#ifdef _WIN32
+		if (bytes != nullptr && copy.empty())
+			UnmapViewOfFile(bytes);
+		if (mapping != nullptr)
+			CloseHandle(mapping);
+		if (file != INVALID_HANDLE_VALUE)
+			CloseHandle(file);
+		mapping = nullptr;
+		file = INVALID_HANDLE_VALUE;
+#else
+		if (mapped != nullptr)
+			munmap(mapped, length);
+		mapped = nullptr;
+#endif
+		bytes = nullptr;
+		length = 0;
+		copy.clear();
+	}
+
+	const char* data() const { return bytes; }
+	std::size_t size() const { return length; }
+
+	// Paging hints for bytes [from, from + count): read them ahead, or drop them from this process's memory (they
+	// are paged back in from the file if touched again). No-ops for a copy and where madvise is unavailable.
+	void will_need(std::size_t from, std::size_t count) const {
+#ifndef _WIN32
+		if (mapped != nullptr && count > 0) {
+			std::size_t page = std::size_t(sysconf(_SC_PAGESIZE));
+			std::size_t begin = from / page * page, end = std::min(length, from + count);
+			if (begin < end)
+				madvise(static_cast<char*>(mapped) + begin, end - begin, MADV_WILLNEED);
+		}
+#endif
+		(void)from;
+		(void)count;
+	}
+	void done_with(std::size_t from, std::size_t count) const {
+#ifndef _WIN32
+		// whole pages inside the range only, so the neighbours' pages stay
+		std::size_t page = std::size_t(sysconf(_SC_PAGESIZE));
+		std::size_t begin = (from + page - 1) / page * page, end = std::min(length, from + count) / page * page;
+		if (mapped != nullptr && begin < end)
+			madvise(static_cast<char*>(mapped) + begin, end - begin, MADV_DONTNEED);
+#endif
+		(void)from;
+		(void)count;
+	}
+
+private:
+#ifdef _WIN32
+	bool read_all(HANDLE from) {
+		copy.clear();
+		char buf[1 << 16];
+		DWORD got;
+		while (ReadFile(from, buf, sizeof(buf), &got, nullptr) && got > 0)
+			copy.insert(copy.end(), buf, buf + got);
+		bytes = copy.data();
+		length = copy.size();
+		return true;
+	}
+#else
+	bool read_all(int fd) {
+		copy.clear();
+		char buf[1 << 16];
+		for (;;) {
+			ssize_t got = ::read(fd, buf, sizeof(buf));
+			if (got < 0 && errno == EINTR)
+				continue;
+			if (got < 0)
+				return false;
+			if (got == 0)
+				break;
+			copy.insert(copy.end(), buf, buf + got);
+		}
+		bytes = copy.data();
+		length = copy.size();
+		return true;
+	}
+#endif
+};
+
+// Scan an optionally signed decimal integer at p, skipping blanks but not line ends; false (p at the line end
+// or the first bad character) when there is none or it does not fit in an int
+inline bool scan_int(const char*& p, const char* end, int& value) {
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+		p++;
+	bool negative = p < end && *p == '-';
+	if (p < end && (*p == '-' || *p == '+'))
+		p++;
+	if (p == end || unsigned(*p - '0') > 9)
+		return false;
+	long long x = 0;
+	for (; p < end && unsigned(*p - '0') <= 9; p++) {
+		x = x * 10 + (*p - '0');
+		if (x > (long long)std::numeric_limits<int>::max() + 1)
+			return false;
+	}
+	x = negative ? -x : x;
+	if (x > std::numeric_limits<int>::max() || x < std::numeric_limits<int>::min())
+		return false;
+	value = int(x);
+	return true;
+}
+
+// Build graph's CSR adjacency from its edges on several threads, laid out as Graph::build() does
+inline void build_adjacency(Graph& graph, unsigned threads = 0) {
+	std::size_t n = std::size_t(graph.n), m = graph.edges.size();
+	unsigned workers = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+	// a thread needs enough edges to pay for its own counts per vertex
+	workers = unsigned(std::max<std::size_t>(1, std::min<std::size_t>(workers, m / std::max<std::size_t>(n, 1 << 16))));
+	if (workers <= 1) {
+		graph.build();
+		return;
+	}
+	auto slice = [&](unsigned t) { return std::make_pair(m * t / workers, m * (t + 1) / workers); };
+	std::vector<std::vector<int>> counts(workers);
+	auto run = [&](auto body) {
+		std::vector<std::thread> pool;
+		for (unsigned t = 1; t < workers; t++)
+			pool.emplace_back(body, t);
+		body(0u);
+		for (auto& th : pool)
+			th.join();
+	};
+	run([&](unsigned t) {
+		std::vector<int>& c = counts[t];
+		c.assign(n, 0);
+		for (std::size_t i = slice(t).first; i < slice(t).second; i++) {
+			c[std::size_t(graph.edges[i].u)]++;
+			c[std::size_t(graph.edges[i].v)]++;
+		}
+	});
+	// offset per vertex, and each thread's first write position per vertex in counts[t]
+	graph.offset.assign(n + 1, 0);
+	int at = 0;
+	for (std::size_t v = 0; v < n; v++) {
+		graph.offset[v] = at;
+		for (unsigned t = 0; t < workers; t++) {
+			int c = counts[t][v];
+			counts[t][v] = at;
+			at += c;
+		}
+	}
+	graph.offset[n] = at;
+	graph.adj.resize(2 * m);
+	graph.adj_w.resize(2 * m);
+	run([&](unsigned t) {
+		std::vector<int>& pos = counts[t];
+		for (std::size_t i = slice(t).first; i < slice(t).second; i++) {
+			const Edge& e = graph.edges[i];
+			graph.adj[std::size_t(pos[e.u])] = e.v;
+			graph.adj_w[std::size_t(pos[e.u]++)] = e.w;
+			graph.adj[std::size_t(pos[e.v])] = e.u;
+			graph.adj_w[std::size_t(pos[e.v]++)] = e.w;
+		}
+	});
+}
+
+// Parse "V E" + "u v w" text held in [begin, end) on several threads; false when the header is missing
+inline bool parse_graph(const char* begin, const char* end, Graph& graph, unsigned threads = 0) {
+	const char* p = begin;
+	int header[2];
+	for (int k = 0; k < 2;) {
+		if (scan_int(p, end, header[k])) {
+			k++;
+			continue;
+		}
+		if (p == end || *p != '\n')
+			return false;
+		p++; // the header may span lines
+	}
+	int v = header[0], e = header[1];
+	if (v < 0 || e < 0)
+		return false;
+	while (p < end && *p++ != '\n') {} // rest of the header line
+
+	// chunks of at least 1 MiB, cut after a line end
+	unsigned workers = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+	workers = unsigned(std::max<std::size_t>(1, std::min<std::size_t>(workers, std::size_t(end - p) >> 20)));
+	std::vector<const char*> cut(workers + 1, end);
+	cut[0] = p;
+	for (unsigned t = 1; t < workers; t++) {
+		const char* q = std::max(cut[t - 1], p + (end - p) * std::ptrdiff_t(t) / std::ptrdiff_t(workers));
+		while (q < end && q[-1] != '\n')
+			q++;
+		cut[t] = q;
+	}
+
+	// records per chunk; a dropped record is kept with u = -1 so the first E records can be told apart
+	std::vector<std::vector<Edge>> records(workers);
+	auto parse = [&](unsigned t) {
+		std::vector<Edge>& out = records[t];
+		out.reserve(std::size_t(cut[t + 1] - cut[t]) / 8);
+		for (const char* q = cut[t]; q < cut[t + 1];) {
+			int from, to, w;
+			if (scan_int(q, cut[t + 1], from) && scan_int(q, cut[t + 1], to) && scan_int(q, cut[t + 1], w)) {
+				bool valid = from > 0 && from <= v && to > 0 && to <= v && from != to;
+				out.push_back(valid ? Edge{ from - 1, to - 1, w } : Edge{ -1, -1, 0 });
+			}
+			while (q < cut[t + 1] && *q++ != '\n') {}
+		}
+	};
+	std::vector<std::thread> pool;
+	for (unsigned t = 1; t < workers; t++)
+		pool.emplace_back(parse, t);
+	parse(0);
+	for (auto& th : pool)
+		th.join();
+
+	graph = Graph();
+	graph.n = v;
+	std::size_t total = 0, kept = 0;
+	for (const auto& r : records)
+		total += r.size();
+	graph.edges.reserve(std::min(total, std::size_t(e)));
+	for (auto& r : records) {
+		for (std::size_t i = 0; i < r.size() && kept < std::size_t(e); i++, kept++) {
+			if (r[i].u >= 0)
+				graph.edges.push_back(r[i]);
+		}
+		std::vector<Edge>().swap(r);
+	}
+	build_adjacency(graph, threads);
+	return true;
+}
+
+// Read "V E" + "u v w" text from a stream such as stdin or a pipe, as it arrives: chunk by chunk, each
+// complete line parsed at once (a line cut by the chunk end is moved to the front of the buffer), so the
+// parse keeps pace with the producer instead of starting at end of input. Edges go straight into
+// graph.edges, reserved from the header's E, and endpoint counts are kept as they arrive, so at the end
+// only the CSR scatter is left and memory stays at the graph itself plus one chunk. Records are filtered
+// as in parse_graph(); reading stops after E records.
+inline bool read_graph_stream(std::FILE* in, Graph& graph, std::size_t chunk = std::size_t(1) << 20) {
+	graph = Graph();
+	std::vector<char> buf(std::max<std::size_t>(chunk, 64));
+	int header[2] = { 0, 0 };
+	int have = 0; // header fields read
+	bool bad = false, done = false;
+	std::size_t records = 0;
+	std::vector<int>& count = graph.offset; // count[v + 1]: edges at v so far, prefix-summed at the end
+	auto take = [&](const char* p, const char* end) { // one line, without its '\n'
+		if (have < 2) { // the header may span lines
+			while (have < 2 && scan_int(p, end, header[have]))
+				have++;
+			if (have < 2 && p != end)
+				bad = done = true;
+			else if (have == 2) {
+				if (header[0] < 0 || header[1] < 0) {
+					bad = done = true;
+					return;
+				}
+				graph.n = header[0];
+				graph.edges.reserve(std::min<std::size_t>(std::size_t(header[1]), std::size_t(1) << 26)); // trust E up to 64M
+				count.assign(std::size_t(header[0]) + 1, 0);
+				done = header[1] == 0;
+			}
+			return;
+		}
+		int from, to, w;
+		if (!scan_int(p, end, from) || !scan_int(p, end, to) || !scan_int(p, end, w))
+			return;
+		done = ++records == std::size_t(header[1]);
+		if (from <= 0 || from > graph.n || to <= 0 || to > graph.n || from == to)
+			return;
+		graph.edges.push_back(Edge{ from - 1, to - 1, w });
+		count[std::size_t(from)]++;
+		count[std::size_t(to)]++;
+	};
+
+	std::size_t carry = 0; // bytes of an unfinished line at the front of buf
+	while (!done) {
+		std::size_t got = std::fread(buf.data() + carry, 1, buf.size() - carry, in);
+		if (got == 0) {
+			if (carry > 0)
+				take(buf.data(), buf.data() + carry); // last line without '\n'
+			break;
+		}
+		const char* p = buf.data();
+		const char* stop = buf.data() + carry + got;
+		for (const char* nl; !done && (nl = static_cast<const char*>(std::memchr(p, '\n', std::size_t(stop - p)))) != nullptr; p = nl + 1)
+			take(p, nl);
+		carry = done ? 0 : std::size_t(stop - p);
+		std::memmove(buf.data(), p, carry);
+		if (carry == buf.size()) // a line longer than the buffer
+			buf.resize(2 * buf.size());
+	}
+	if (bad || have < 2)
+		return false;
+
+	// offsets from the counts, then one scatter pass, laid out as Graph::build() does
+	for (std::size_t v = 0; v < std::size_t(graph.n); v++)
+		count[v + 1] += count[v];
+	std::size_t m = graph.edges.size();
+	graph.adj.resize(2 * m);
+	graph.adj_w.resize(2 * m);
+	std::vector<int> pos(count.begin(), count.end() - 1);
+	for (const Edge& e : graph.edges) {
+		graph.adj[std::size_t(pos[e.u])] = e.v;
+		graph.adj_w[std::size_t(pos[e.u]++)] = e.w;
+		graph.adj[std::size_t(pos[e.v])] = e.u;
+		graph.adj_w[std::size_t(pos[e.v]++)] = e.w;
+	}
+	return true;
+}
+
+// Load a graph file through a memory map
+inline bool load_graph_mapped(const std::string& path, Graph& graph, unsigned threads = 0) {
+	MappedFile file;
+	return file.open(path) && parse_graph(file.data(), file.data() + file.size(), graph, threads);
+}
+
+} // namespace maxcut
@@ -0,0 +1,163 @@
+// Unified max-cut solver: runs one of the ported GAs (variants.h) on maxcut.in and writes maxcut.out
+// usage: maxcut [variant] [seconds] [survivors] [relink] [order] [input] [budget]
+//   variant    auto (default: exact up to 64 vertices after reduction, basic beyond), basic, 20211343, 20211291,
+//              20211301, 20211327, 20211327-local, sa (simulated annealing), eda (estimation of distribution),
+//              exact (branch and bound, up to 64 vertices), ml-<variant> (multilevel, <variant> on the coarsest
+//              graph), cc-<variant> (each connected component solved with <variant>, which may be ml-<variant>)
+//              or ooc-<variant> (a GA or eda scoring straight from a binary graph file on disk, out_of_core.h;
+//              no reduction, bound, greedy seeding or relinking, as those need the graph in memory)
+//   seconds    time limit, 175 by default
+//   survivors  replacement: default (the variant's own), plus (mu + lambda), comma (mu, lambda),
+//              crowding (deterministic crowding) or rtr (restricted tournament replacement)
+//              (GA variants only)
+//   relink     elites path-relinked toward the best once per population turnover, 4 by default, 0 for none
+//   order      vertex renumbering for locality: none, bfs (default), rcm or degree
+//   input      graph file, maxcut.in by default; - reads the text format from stdin as it arrives
+//   budget     memory for the out-of-core evaluation in MiB, 256 by default (ooc- variants only)
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "bounds.h"
+#include "deadline.h"
+#include "graph.h"
+#include "graph_file.h"
+#include "incumbent.h"
+#include "kernel.h"
+#include "loader.h"
+#include "out_of_core.h"
+#include "reorder.h"
+#include "variants.h"
+using namespace std;
+
+int main(int argc, char* argv[])
+{
+	// fast I/O
+	ios::sync_with_stdio(false); cin.tie(NULL); cout.tie(NULL);
+
+	string variant = (argc > 1 ? argv[1] : "auto"); // engine to run
+	double due = (argc > 2 ? atof(argv[2]) : 175.0); // time limit (seconds)
+	maxcut::VariantOptions options;
+	if (argc > 3 && !maxcut::parse_survivors(argv[3], options.survivors)) {
+		cerr << "unknown survivor selection: " << argv[3] << "\n";
+		return 1;
+	}
+	if (argc > 4)
+		options.relink_pairs = size_t(max(0, atoi(argv[4])));
+	maxcut::Ordering ordering = maxcut::Ordering::bfs;
+	if (argc > 5 && !maxcut::parse_ordering(argv[5], ordering)) {
+		cerr << "unknown vertex order: " << argv[5] << "\n";
+		return 1;
+	}
+	string input = (argc > 6 ? argv[6] : "maxcut.in");
+	maxcut::Deadline deadline(due); // the time spent reading the input counts too
+
+	// output: the incumbent rewrites maxcut.out atomically on every improvement
+	maxcut::Incumbent incumbent{ "maxcut.out" };
+	maxcut::install_stop_handlers(&incumbent); // on SIGINT/SIGTERM write the best cut and exit at once
+
+	// out of core: the edges stay on disk and every batch of genomes is scored in streamed passes over them
+	if (variant.compare(0, 4, "ooc-") == 0) {
+		maxcut::StreamConfig stream;
+		if (argc > 7)
+			stream.memory_budget = size_t(max(1, atoi(argv[7]))) << 20;
+		maxcut::StreamedCutEvaluator evaluate;
+		if (!evaluate.open(input, stream)) {
+			cerr << input << " is not a valid binary graph file (convert.cpp makes one)\n";
+			return 1;
+		}
+		maxcut::EngineConfig config;
+		config.greedy_fraction = 0;
+		config.relink_pairs = 0;
+		size_t v = size_t(max(evaluate.problem().size(), 1));
+		bool found = maxcut::with_population_variant<maxcut::BitGenome>(variant.substr(4), v, evaluate.edge_count(), evaluate,
+			config, [&](auto& engine) {
+			engine.set_incumbent(&incumbent);
+			engine.run(deadline);
+			cerr << variant << ": cut " << incumbent.best() << ", " << engine.generation_count() << " generations, "
+				<< engine.restart_count() << " restarts, " << deadline.elapsed() << "s\n";
+		}, options);
+		if (!found) {
+			cerr << "unknown variant: " << variant << " (ooc- takes a GA or eda)\n";
+			return 1;
+		}
+		incumbent.flush();
+		return 0;
+	}
+
+	maxcut::Graph graph;
+	// stdin is parsed chunk by chunk while it arrives; a binary graph file (graph_file.h) is copied straight in;
+	// other text is memory-mapped and parsed on every hardware thread
+	bool loaded = (input == "-" ? maxcut::read_graph_stream(stdin, graph) : maxcut::load_graph_any(input, graph));
+	if (!loaded) {
+		cerr << "cannot read " << (input == "-" ? "stdin" : input) << "\n";
+		return 1;
+	}
+
+	// safe reductions first (kernel.h): the engines solve the kernel and the incumbent lifts their answers; the
+	// reductions stop at the deadline, leaving a partial kernel
+	maxcut::Kernel kernel;
+	kernel.reduce(graph, &deadline);
+	cerr << "kernel: " << graph.size() << " -> " << kernel.graph.size() << " vertices, " << graph.edge_count() << " -> "
+		<< kernel.graph.edge_count() << " edges (" << kernel.ratio() * 100 << "%)\n";
+	// then renumber the kernel for locality (reorder.h); answers go back through both maps
+	maxcut::Renumbering renumbering;
+	renumbering.apply(kernel.graph, ordering);
+	const maxcut::Graph& problem = renumbering.graph;
+	incumbent.set_lift([&](vector<uint8_t>& sides) {
+		renumbering.restore(sides);
+		kernel.lift(sides);
+	}, kernel.constant());
+	if (problem.size() == 0) { // fully reduced: the lifted empty partition is optimal
+		incumbent.offer(0, 0, [](size_t) { return false; });
+		incumbent.flush();
+		cerr << "cut " << incumbent.best() << " by reduction alone\n";
+		return 0;
+	}
+	if (deadline.expired()) { // no time left for an engine: the lifted empty partition still makes an answer
+		incumbent.offer(0, size_t(problem.size()), [](size_t) { return false; });
+		incumbent.flush();
+		cerr << "cut " << incumbent.best() << ", time ran out during the reductions\n";
+		return 0;
+	}
+
+	// upper bound (bounds.h): a balanced (bipartite) kernel is solved by its 2-colouring, otherwise the engines
+	// stop as soon as the incumbent reaches the bound
+	vector<uint8_t> colouring;
+	maxcut::CutBounds bounds = maxcut::cut_bounds(problem, colouring);
+	incumbent.set_target(bounds.upper());
+	cerr << "upper bound " << kernel.constant() + bounds.upper() << " (positive weight " << kernel.constant() + bounds.positive
+		<< ", " << bounds.cycles << " frustrated cycles)\n";
+	if (bounds.balanced) {
+		incumbent.offer(bounds.positive, colouring.size(), [&](size_t i) { return colouring[i] == colouring[0]; });
+		incumbent.flush();
+		cerr << "cut " << incumbent.best() << " by 2-colouring (optimal)\n";
+		return 0;
+	}
+
+	// small graphs get a fixed-size genome that lives inline in the population array
+	bool found = maxcut::dispatch_genome(size_t(problem.size()), [&](auto tag) {
+		using Genome = typename decltype(tag)::type;
+		return maxcut::with_variant<Genome>(variant, problem, 0, [&](auto& engine) {
+			engine.set_incumbent(&incumbent);
+			engine.run(deadline);
+			cerr << variant << ": cut " << incumbent.best() << ", " << engine.generation_count() << " generations, "
+				<< engine.restart_count() << " restarts, " << deadline.elapsed() << "s\n";
+		}, options);
+	});
+	if (!found) {
+		if (variant == "exact")
+			cerr << "exact handles at most " << maxcut::ExactEngine::max_vertices << " vertices, the kernel has " << problem.size() << "\n";
+		else
+			cerr << "unknown variant: " << variant << "\n";
+		return 1;
+	}
+	if (incumbent.optimal())
+		cerr << "the cut is optimal (it reached a proven upper bound)\n";
+
+	incumbent.flush(); // every evaluated genome was offered, so the incumbent holds the final answer
+	return 0;
+}
@@ -0,0 +1,228 @@
+#pragma once
+// Multilevel coarsen - solve - refine
+// Coarsening contracts a heavy-edge matching. A matched pair (u, v) becomes one coarse vertex with a fixed
+// relative orientation: opposite sides when w(u, v) > 0 (the edge is always cut), the same side when w < 0.
+// A fine vertex then sits on side (coarse side) ^ orient[v], and an edge (a, b) between different coarse
+// vertices is cut
+//   when the coarse ends differ, if a and b have the same orientation: coarse weight +w
+//   when the coarse ends agree, otherwise: a constant w plus coarse weight -w
+// so every fine cut equals a constant plus the coarse cut, exactly, and the coarse graph carries signed
+// weights (which every evaluator here accepts). Parallel coarse edges are merged, unless their sum leaves int
+// range: such a pair stays as parallel edges.
+// MultilevelEngine coarsens down to about coarse_size vertices, hands the coarsest graph to a solver (any
+// variant, see variants.h), then projects the partition back one level at a time, refining each level to a
+// single-flip local optimum with FlipState. The time left after the last level goes to iterated local search
+// (perturb a few vertices of the best partition, descend, keep if better) on the original graph.
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+#include "deadline.h"
+#include "flip_state.h"
+#include "genome.h"
+#include "graph.h"
+#include "incumbent.h"
+
+namespace maxcut {
+
+// One contraction: vertices of the finer graph -> vertices of `graph`
+struct CoarseLevel {
+	Graph graph; // the coarser graph
+	std::vector<int> parent; // coarse vertex of each finer vertex
+	std::vector<std::uint8_t> orient; // finer side = coarse side ^ orient
+	long long constant = 0; // finer cut = constant + coarse cut
+};
+
+// Contract a heavy-edge matching of fine (vertices visited in random order, each matched to its unmatched
+// neighbour with the largest |w|) into level
+inline void coarsen(const Graph& fine, Rng& rng, CoarseLevel& level) {
+	std::size_t n = std::size_t(fine.size());
+	std::vector<int> order(n);
+	std::iota(order.begin(), order.end(), 0);
+	std::shuffle(order.begin(), order.end(), rng);
+	level.parent.assign(n, -1);
+	level.orient.assign(n, 0);
+	int coarse_n = 0;
+	for (int v : order) {
+		if (level.parent[v] >= 0)
+			continue;
+		int mate = -1;
+		long long heaviest = 0;
+		for (int k = fine.offset[v]; k < fine.offset[v + 1]; k++) {
+			int u = fine.adj[k];
+			long long w = fine.adj_w[k] < 0 ? -(long long)fine.adj_w[k] : fine.adj_w[k];
+			if (level.parent[u] < 0 && u != v && w > heaviest) {
+				heaviest = w;
+				mate = u;
+			}
+		}
+		level.parent[v] = coarse_n;
+		if (mate >= 0) {
+			long long w = 0; // the edge that chose the mate decides the orientation
+			for (int k = fine.offset[v]; k < fine.offset[v + 1]; k++) {
+				if (fine.adj[k] == mate)
+					w += fine.adj_w[k];
+			}
+			level.parent[mate] = coarse_n;
+			level.orient[mate] = w > 0;
+		}
+		coarse_n++;
+	}
+
+	// contract the edges; parallel coarse edges are merged by sorting
+	level.constant = 0;
+	std::vector<std::pair<std::pair<int, int>, long long>> merged;
+	merged.reserve(fine.edge_count());
+	for (const Edge& e : fine.edges) {
+		int a = level.parent[e.u], b = level.parent[e.v];
+		bool same = level.orient[e.u] == level.orient[e.v];
+		if (a == b) {
+			level.constant += same ? 0 : e.w; // inside a coarse vertex: cut exactly when the orientations differ
+			continue;
+		}
+		if (!same)
+			level.constant += e.w;
+		merged.push_back({ { std::min(a, b), std::max(a, b) }, same ? e.w : -(long long)e.w });
+	}
+	std::sort(merged.begin(), merged.end(),
+		[](const std::pair<std::pair<int, int>, long long>& x, const std::pair<std::pair<int, int>, long long>& y) {
+			return x.first < y.first;
+		});
+	std::vector<Edge> edges;
+	for (std::size_t i = 0; i < merged.size();) {
+		std::size_t j = i;
+		long long w = 0;
+		for (; j < merged.size() && merged[j].first == merged[i].first; j++)
+			w += merged[j].second;
+		append_edge(edges, merged[i].first.first, merged[i].first.second, w); // split again if beyond int range
+		i = j;
+	}
+	level.graph = Graph(coarse_n, std::move(edges));
+}
+
+struct MultilevelConfig {
+	std::size_t coarse_size = 1000; // stop coarsening at this many vertices
+	double min_shrink = 0.95; // or when a level keeps more than this share of the vertices
+	std::size_t max_levels = 40;
+	double solve_fraction = 0.85; // share of the time given to the coarsest solve
+	std::size_t perturb = 0; // vertices flipped per local search round, 0 for max(2, V / 100)
+	std::uint64_t seed = 0; // random seed, 0 for std::random_device
+};
+
+// Solve is called as long long solve(const Graph& coarsest, Deadline&, std::vector<std::uint8_t>& sides)
+// and returns the coarse cut with the partition in sides (LLONG_MIN for none)
+template <class Solve>
+class MultilevelEngine {
+private:
+	const Graph* graph; // finest graph
+	Solve solve;
+	MultilevelConfig config;
+	Rng rng;
+	std::vector<CoarseLevel> levels; // levels[0] coarsens *graph, levels[k] coarsens levels[k - 1].graph
+	Incumbent* incumbent = nullptr; // anytime output
+	std::vector<std::uint8_t> best; // best partition of the finest graph
+	long long best_cost = LLONG_MIN;
+	std::size_t rounds = 0; // local search rounds after the refinement
+
+public:
+	MultilevelEngine(const Graph& graph, Solve solve, MultilevelConfig config = MultilevelConfig())
+		: graph(&graph), solve(solve), config(config) {
+		rng.seed(config.seed != 0 ? config.seed : (std::uint64_t(std::random_device{}()) << 32) ^ std::random_device{}());
+	}
+
+	// Report every improvement to this incumbent
+	void set_incumbent(Incumbent* incumbent) { this->incumbent = incumbent; }
+
+	long long run(Deadline& deadline) {
+		if (graph->size() == 0 || deadline.expired())
+			return best_cost;
+		build();
+		const Graph& coarsest = levels.empty() ? *graph : levels.back().graph;
+
+		// a random coarse partition carried up first, so an answer exists while the solver runs
+		std::vector<std::uint8_t> sides(std::size_t(coarsest.size()));
+		for (auto& s : sides)
+			s = std::uint8_t(rng() >> 63);
+		uncoarsen(sides);
+
+		Deadline solve_deadline = deadline.slice(config.solve_fraction);
+		if (solve(coarsest, solve_deadline, sides) != LLONG_MIN && sides.size() == std::size_t(coarsest.size()))
+			uncoarsen(sides);
+		local_search(deadline);
+		return best_cost;
+	}
+
+	const std::vector<std::uint8_t>& best_genome() const { return best; }
+	long long best_value() const { return best_cost; }
+	// Local search rounds, reported where the GA engines report generations
+	std::size_t generation_count() const { return rounds; }
+	int restart_count() const { return 0; }
+	std::size_t level_count() const { return levels.size(); }
+
+private:
+	void build() {
+		levels.clear();
+		const Graph* g = graph;
+		while (std::size_t(g->size()) > config.coarse_size && levels.size() < config.max_levels) {
+			CoarseLevel level;
+			coarsen(*g, rng, level);
+			if (double(level.graph.size()) > config.min_shrink * double(g->size()))
+				break;
+			levels.push_back(std::move(level));
+			g = &levels.back().graph;
+		}
+	}
+
+	// Project a partition of the coarsest graph to the finest, refining every level on the way
+	void uncoarsen(std::vector<std::uint8_t> sides) {
+		for (std::size_t k = levels.size(); k-- > 0;) {
+			const CoarseLevel& level = levels[k];
+			std::vector<std::uint8_t> finer(level.parent.size());
+			for (std::size_t v = 0; v < finer.size(); v++)
+				finer[v] = sides[level.parent[v]] ^ level.orient[v];
+			const Graph& g = k > 0 ? levels[k - 1].graph : *graph;
+			FlipState state(g);
+			state.assign([&](std::size_t v) { return finer[v] != 0; });
+			state.descend();
+			sides = state.partition();
+		}
+		FlipState state(*graph);
+		state.assign([&](std::size_t v) { return sides[v] != 0; });
+		state.descend();
+		offer(state);
+	}
+
+	// Iterated local search on the finest graph until the deadline
+	void local_search(Deadline& deadline) {
+		std::size_t n = std::size_t(graph->size());
+		std::size_t k = config.perturb ? config.perturb : std::max<std::size_t>(2, n / 100);
+		FlipState state(*graph);
+		state.assign([&](std::size_t v) { return best[v] != 0; });
+		std::uniform_int_distribution<int> dis(0, int(n) - 1);
+		while (!deadline.expired()) {
+			for (std::size_t i = 0; i < k; i++)
+				state.flip(dis(rng));
+			state.descend();
+			rounds++;
+			if (state.cut() > best_cost)
+				offer(state);
+			else
+				state.assign([&](std::size_t v) { return best[v] != 0; });
+		}
+	}
+
+	void offer(const FlipState& state) {
+		if (state.cut() <= best_cost)
+			return;
+		best_cost = state.cut();
+		best = state.partition();
+		if (incumbent != nullptr)
+			incumbent->offer(best_cost, best.size(), [&](std::size_t i) { return best[i] == best[0]; });
+	}
+};
+
+} // namespace maxcut
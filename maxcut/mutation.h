@@ -0,0 +1,88 @@
+#pragma once
+// Mutation policies
+// Every policy provides void operator()(Genome&, Rng&).
+#include <cstddef>
+#include <random>
+#include "genome.h"
+
+namespace maxcut {
+
+// Each gene flips independently with probability rate (20211343: 0.01, 20211291: 0.05).
+// The gaps between flipped genes are drawn from a geometric distribution, so the cost is O(flips), not O(n).
+class FlipMutation {
+private:
+	double rate; // per-gene flip probability
+
+public:
+	explicit FlipMutation(double rate = 0.01) : rate(rate) {}
+
+	template <class Genome>
+	void operator()(Genome& g, Rng& rng) const {
+		if (rate <= 0)
+			return;
+		if (rate >= 1) {
+			for (std::size_t i = 0; i < g.size(); i++)
+				g.flip(i);
+			return;
+		}
+		std::geometric_distribution<std::size_t> gap(rate);
+		for (std::size_t i = gap(rng); i < g.size(); i += 1 + gap(rng))
+			g.flip(i);
+	}
+};
+
+// With probability rate, flip one random gene (20211327)
+class SingleFlipMutation {
+private:
+	double rate; // probability of a flip per child
+
+public:
+	explicit SingleFlipMutation(double rate = 0.01) : rate(rate) {}
+
+	template <class Genome>
+	void operator()(Genome& g, Rng& rng) const {
+		std::size_t i = std::uniform_int_distribution<std::size_t>(0, g.size() - 1)(rng);
+		if (std::uniform_real_distribution<double>(0, 1)(rng) < rate)
+			g.flip(i);
+	}
+};
+
+// Flip probability grows along the genome: gene i flips with probability step * (1 + i / every) (20211301)
+class RampMutation {
+private:
+	double step; // probability increment
+	std::size_t every; // genes per increment
+
+public:
+	explicit RampMutation(double step = 0.0005, std::size_t every = 10) : step(step), every(every) {}
+
+	template <class Genome>
+	void operator()(Genome& g, Rng& rng) const {
+		std::uniform_real_distribution<double> dis(0, 1);
+		for (std::size_t i = 0; i < g.size(); i++) {
+			if (dis(rng) <= step * double(1 + i / every))
+				g.flip(i);
+		}
+	}
+};
+
+// Run another mutation, then flip one random vertex if that increases the cut (20211327 NewGA "LocalOptimum")
+template <class Inner, class Evaluator>
+class LocalFlipMutation {
+private:
+	Inner inner; // mutation applied first
+	Evaluator evaluate; // for the O(deg) flip gain
+
+public:
+	LocalFlipMutation(Inner inner, Evaluator evaluate) : inner(inner), evaluate(evaluate) {}
+
+	template <class Genome>
+	void operator()(Genome& g, Rng& rng) const {
+		inner(g, rng);
+		int v = std::uniform_int_distribution<int>(0, int(g.size()) - 1)(rng);
+		if (evaluate.flip_gain(g, v) > 0)
+			g.flip(std::size_t(v));
+	}
+};
+
+} // namespace maxcut
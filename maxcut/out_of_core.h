@@ -0,0 +1,157 @@
+#pragma once
+// Out-of-core cut evaluation straight from a binary graph file (graph_file.h), for graphs that do not fit in
+// memory next to a population
+// The edge list is never loaded: each batch() streams it from the mapping in blocks, reading the next block
+// ahead while the current one is scored and dropping every block from memory once done. A block is scored for
+// the whole batch at once, bit-sliced as in sliced.h, so one read of the edges serves every genome of the
+// batch. The vertex planes of the batch and the blocks in flight are kept within a memory budget; a batch
+// that does not fit is scored in as many passes as it needs, with at least one group of lanes per pass.
+// The evaluator has the interface of CutEvaluator, so the generational engines run on it unchanged; problem()
+// is an edgeless stand-in, though, so they must run with greedy_fraction 0 and relink_pairs 0 (greedy
+// construction and path relinking need the adjacency in memory).
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "graph.h"
+#include "graph_file.h"
+#include "sliced.h"
+
+namespace maxcut {
+
+struct StreamConfig {
+	std::size_t memory_budget = std::size_t(256) << 20; // bytes for the vertex planes and the edge blocks in flight
+	std::size_t block_edges = std::size_t(1) << 20; // edges per block, at most; shrunk to fit the budget
+	bool verify = false; // also check the file's content hash when opening it (the indices are always checked)
+};
+
+class StreamedCutEvaluator {
+public:
+	static constexpr std::size_t W = SliceLanes::words; // 64-bit words per vertex and group of lanes
+	static constexpr std::size_t lanes = 64 * W; // partitions per group
+
+private:
+	struct Source {
+		GraphFile file;
+		Graph vertices; // the vertices alone, for problem()
+	};
+	std::shared_ptr<const Source> source;
+	StreamConfig config;
+	mutable std::vector<std::uint64_t> sides; // sides[v * groups * W + g * W + l]: lane 64 l .. of group g at v
+	mutable std::vector<SliceCounters> counters; // one per group of the pass
+	mutable std::size_t passes = 0; // passes over the edge list so far
+
+public:
+	// Map path; false when it is not a well-formed graph file (nor, with config.verify, one whose hash matches).
+	// GraphFile::open range-checks every endpoint, which is what lets scan() index sides without checks.
+	bool open(const std::string& path, StreamConfig config = StreamConfig()) {
+		auto s = std::make_shared<Source>();
+		if (!s->file.open(path, config.verify))
+			return false;
+		s->vertices.n = s->file.size();
+		s->vertices.offset.assign(std::size_t(s->file.size()) + 1, 0);
+		source = std::move(s);
+		this->config = config;
+		return true;
+	}
+
+	const Graph& problem() const { return source->vertices; }
+	const GraphFile& file() const { return source->file; }
+	std::size_t edge_count() const { return source->file.edge_count(); }
+	std::size_t pass_count() const { return passes; }
+
+	// Cut weight of a genome: a pass of its own, so prefer batch()
+	template <class Genome>
+	long long operator()(const Genome& g) const {
+		long long cost;
+		batch(&g, 1, &cost);
+		return cost;
+	}
+
+	// Cut weights of genomes[0 .. count) into costs, as few passes over the edge list as the budget allows
+	template <class Genome>
+	void batch(const Genome* genomes, std::size_t count, long long* costs) const {
+		const GraphFile& f = source->file;
+		std::size_t n = std::size_t(f.size()), m = f.edge_count();
+		std::size_t row = 8 + f.weight_bytes(); // bytes per edge
+		std::size_t block = std::max<std::size_t>(4096, std::min(config.block_edges, config.memory_budget / (4 * row)));
+		std::size_t window = 2 * block * row; // the block being scored and the one read ahead
+		std::size_t group_bytes = std::max<std::size_t>(1, n * W * 8);
+		std::size_t groups = (count + lanes - 1) / lanes;
+		std::size_t per_pass = config.memory_budget > window ? (config.memory_budget - window) / group_bytes : 0;
+		per_pass = std::max<std::size_t>(1, std::min(per_pass, groups));
+		// a cut sums at most m weights of 2^(8 * weight_bytes - 1) each
+		std::size_t width = 8 * f.weight_bytes() - 1;
+		std::uint64_t total = width + bit_length(m) >= 63 ? ~std::uint64_t(0) >> 1 : std::uint64_t(m) << width;
+
+		for (std::size_t first = 0; first < groups; first += per_pass) {
+			std::size_t g_count = std::min(per_pass, groups - first);
+			std::size_t stride = g_count * W;
+			sides.assign(n * stride, 0);
+			counters.assign(g_count, SliceCounters(total));
+			for (std::size_t g = 0; g < g_count; g++) {
+				std::size_t j = (first + g) * lanes;
+				transpose_genomes(genomes + j, std::min(lanes, count - j), n, sides.data() + g * W, stride);
+				counters[g].clear();
+			}
+			for (std::size_t begin = 0; begin < m; begin += block) {
+				std::size_t end = std::min(m, begin + block);
+				if (end < m)
+					f.prefetch_edges(end, std::min(m, end + block));
+				if (f.weight_bytes() == 1)
+					scan(static_cast<const std::int8_t*>(f.edge_weights()), begin, end, g_count);
+				else if (f.weight_bytes() == 2)
+					scan(static_cast<const std::int16_t*>(f.edge_weights()), begin, end, g_count);
+				else
+					scan(static_cast<const std::int32_t*>(f.edge_weights()), begin, end, g_count);
+				f.release_edges(begin, end);
+			}
+			passes++;
+			for (std::size_t g = 0; g < g_count; g++) {
+				std::size_t j = (first + g) * lanes;
+				counters[g].read(std::min(lanes, count - j), costs + j);
+			}
+		}
+	}
+
+	// Change of the cut weight when vertex v moves to the other side, from the file's CSR: O(deg v)
+	template <class Genome>
+	long long flip_gain(const Genome& g, int v) const {
+		const GraphFile& f = source->file;
+		bool side = g.get(v);
+		long long gain = 0;
+		for (std::size_t k = std::size_t(f.offset()[v]); k < std::size_t(f.offset()[v + 1]); k++)
+			gain += (g.get(f.adj()[k]) == side) ? f.adj_weight(k) : -f.adj_weight(k);
+		return gain;
+	}
+
+private:
+	// Bits needed for x
+	static std::size_t bit_length(std::uint64_t x) {
+		std::size_t bits = 0;
+		for (; x != 0; x >>= 1)
+			bits++;
+		return bits;
+	}
+
+	// Add the cut masks of edges [begin, end) for every group of the pass
+	template <class Weight>
+	void scan(const Weight* weights, std::size_t begin, std::size_t end, std::size_t g_count) const {
+		const std::int32_t* eu = source->file.edge_u();
+		const std::int32_t* ev = source->file.edge_v();
+		std::size_t stride = g_count * W;
+		for (std::size_t i = begin; i < end; i++) {
+			const std::uint64_t* su = &sides[std::size_t(eu[i]) * stride];
+			const std::uint64_t* sv = &sides[std::size_t(ev[i]) * stride];
+			for (std::size_t g = 0; g < g_count; g++) {
+				SliceLanes x = SliceLanes::load(su + g * W) ^ SliceLanes::load(sv + g * W);
+				if (x.any())
+					counters[g].add(x, weights[i]);
+			}
+		}
+	}
+};
+
+} // namespace maxcut
@@ -0,0 +1,74 @@
+#pragma once
+// Rejection-free sampling of parent pairs whose cost difference is at most a bound (20211301's selection)
+// build() sorts the individuals by cost once per generation. For the individual at rank r the admissible
+// partners are a contiguous rank range [lo[r], hi[r]]; cumulative[r] counts the admissible ordered pairs
+// whose first member has rank <= r. A pair is then drawn with one binary search over cumulative and one
+// uniform draw inside the window: the same distribution as drawing random pairs until one is admissible,
+// with an O(log P) worst case instead of an unbounded number of attempts.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace maxcut {
+
+class PairWindow {
+private:
+	std::vector<std::size_t> order; // individuals by increasing cost
+	std::vector<std::size_t> lo, hi; // admissible partner ranks of rank r
+	std::vector<std::uint64_t> cumulative; // admissible ordered pairs with first rank <= r
+	double max_cost = 0; // largest cost, cached by build()
+
+public:
+	// Index the costs[0 .. n); partners of an individual may differ by at most window * (largest cost)
+	template <class Cost>
+	void build(const Cost* costs, std::size_t n, double window) {
+		order.resize(n);
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return costs[a] < costs[b]; });
+		max_cost = n ? double(costs[order[n - 1]]) : 0;
+		double max_diff = max_cost * window;
+
+		lo.resize(n);
+		hi.resize(n);
+		cumulative.resize(n);
+		std::uint64_t total = 0;
+		for (std::size_t r = 0, a = 0, b = 0; r < n; r++) { // both window ends only move right
+			double c = double(costs[order[r]]);
+			while (a < n && c - double(costs[order[a]]) > max_diff)
+				a++;
+			if (b < a)
+				b = a;
+			while (b < n && double(costs[order[b]]) - c <= max_diff)
+				b++;
+			lo[r] = a;
+			hi[r] = b; // exclusive
+			total += (b > a) ? b - a : 0;
+			cumulative[r] = total;
+		}
+	}
+
+	std::size_t size() const { return order.size(); }
+	double largest() const { return max_cost; }
+
+	// Two indices with an admissible cost difference (possibly the same individual, as in the original);
+	// a uniform pair when no pair is admissible (negative largest cost)
+	template <class Urbg>
+	std::pair<std::size_t, std::size_t> sample(Urbg& rng) const {
+		std::size_t n = order.size();
+		if (cumulative.empty() || cumulative.back() == 0) {
+			std::uniform_int_distribution<std::size_t> dis(0, n - 1);
+			std::size_t a = dis(rng);
+			return { a, dis(rng) };
+		}
+		std::uint64_t u = std::uniform_int_distribution<std::uint64_t>(0, cumulative.back() - 1)(rng);
+		std::size_t r = std::size_t(std::upper_bound(cumulative.begin(), cumulative.end(), u) - cumulative.begin());
+		std::size_t partner = std::uniform_int_distribution<std::size_t>(lo[r], hi[r] - 1)(rng);
+		return { order[r], order[partner] };
+	}
+};
+
+} // namespace maxcut
@@ -0,0 +1,121 @@
+#pragma once
+// Path relinking between elite partitions
+// Starting from one partition, the vertices on which it differs from the guide are flipped one at a time,
+// always the one with the largest current gain (a lazy max-heap over FlipState gains, re-pushed when a flip
+// changes a neighbour's gain). The best partition strictly between the two ends is kept and, by default,
+// improved to a single-flip local optimum. A guide closer to the start's complement is complemented first,
+// since both describe the same cut. relink_pairs() runs several (start, guide) pairs on separate threads.
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "flip_state.h"
+#include "graph.h"
+
+namespace maxcut {
+
+class PathRelinking {
+private:
+	FlipState state;
+	std::vector<std::uint8_t> pending; // 1 while v still differs from the guide
+	std::vector<std::pair<long long, int>> heap; // (gain when pushed, vertex); stale entries are skipped
+	std::vector<int> path; // flipped vertices in order
+
+public:
+	explicit PathRelinking(const Graph& graph) : state(graph) {}
+
+	// Walk from start(v) toward guide(v); the best intermediate partition goes to out and its cut is returned.
+	// With fewer than two differing vertices there is no intermediate and start itself is used.
+	template <class Start, class Guide>
+	long long operator()(Start start, Guide guide, std::vector<std::uint8_t>& out, bool polish = true) {
+		state.assign(start);
+		std::size_t n = state.size(), distance = 0;
+		for (std::size_t v = 0; v < n; v++)
+			distance += state.side(int(v)) != bool(guide(v));
+		bool complement = 2 * distance > n;
+		pending.assign(n, 0);
+		heap.clear();
+		for (std::size_t v = 0; v < n; v++) {
+			if ((state.side(int(v)) != bool(guide(v))) != complement) {
+				pending[v] = 1;
+				heap.emplace_back(state.gain(int(v)), int(v));
+			}
+		}
+		std::make_heap(heap.begin(), heap.end());
+		distance = complement ? n - distance : distance;
+
+		path.clear();
+		long long best_cut = LLONG_MIN;
+		std::size_t best_step = 0;
+		for (std::size_t step = 1; step < distance; step++) { // the last step would reach the guide
+			int v = pop();
+			state.flip(v);
+			pending[v] = 0;
+			path.push_back(v);
+			const Graph& g = state.problem();
+			for (int k = g.offset[v]; k < g.offset[v + 1]; k++) {
+				int u = g.adj[k];
+				if (pending[u]) {
+					heap.emplace_back(state.gain(u), u);
+					std::push_heap(heap.begin(), heap.end());
+				}
+			}
+			if (state.cut() > best_cut) {
+				best_cut = state.cut();
+				best_step = step;
+			}
+		}
+		// undo the flips made after the best intermediate
+		for (std::size_t step = path.size(); step > best_step; step--)
+			state.flip(path[step - 1]);
+		if (polish)
+			state.descend();
+		out = state.partition();
+		return state.cut();
+	}
+
+private:
+	// Pending vertex with the largest current gain
+	int pop() {
+		while (true) {
+			std::pop_heap(heap.begin(), heap.end());
+			std::pair<long long, int> top = heap.back();
+			heap.pop_back();
+			if (pending[top.second] && top.first == state.gain(top.second))
+				return top.second;
+		}
+	}
+};
+
+// Relink elites[pairs[i].first] toward elites[pairs[i].second] for every i, on up to `threads` threads
+// (0: one per hardware thread). results[i] / costs[i] receive the kept partition and its cut.
+inline void relink_pairs(const Graph& graph, const std::vector<std::vector<std::uint8_t>>& elites,
+	const std::vector<std::pair<std::size_t, std::size_t>>& pairs, std::vector<std::vector<std::uint8_t>>& results,
+	std::vector<long long>& costs, unsigned threads = 0, bool polish = true) {
+	results.resize(pairs.size());
+	costs.assign(pairs.size(), LLONG_MIN);
+	if (threads == 0)
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	threads = unsigned(std::min<std::size_t>(threads, std::max<std::size_t>(pairs.size(), 1)));
+
+	auto work = [&](unsigned t) {
+		PathRelinking relink(graph);
+		for (std::size_t i = t; i < pairs.size(); i += threads) {
+			const std::vector<std::uint8_t>& a = elites[pairs[i].first];
+			const std::vector<std::uint8_t>& b = elites[pairs[i].second];
+			costs[i] = relink([&](std::size_t v) { return a[v] != 0; }, [&](std::size_t v) { return b[v] != 0; },
+				results[i], polish);
+		}
+	};
+	std::vector<std::thread> pool;
+	for (unsigned t = 1; t < threads; t++)
+		pool.emplace_back(work, t);
+	work(0);
+	for (auto& th : pool)
+		th.join();
+}
+
+} // namespace maxcut
@@ -0,0 +1,68 @@
+#pragma once
+// Population with cached costs: operators compare costs[i] instead of re-evaluating genomes
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace maxcut {
+
+template <class Genome>
+struct Population {
+	std::vector<Genome> genomes; // individuals
+	std::vector<long long> costs; // costs[i] is the cut weight of genomes[i]
+	std::vector<std::pair<std::size_t, std::size_t>> parents; // offspring only: population indices of the parents of child i
+	// Replacement log (replacement.h), so the engine can follow who entered and who left: every (slot, child)
+	// swap of an offspring genome into the population, and renewed when the arrays were swapped whole
+	std::vector<std::pair<std::size_t, std::size_t>> exchanges;
+	bool renewed = false;
+
+	std::size_t size() const { return genomes.size(); }
+	bool empty() const { return genomes.empty(); }
+	void clear() {
+		genomes.clear();
+		costs.clear();
+		parents.clear();
+		exchanges.clear();
+		renewed = false;
+	}
+	void reserve(std::size_t n) {
+		genomes.reserve(n);
+		costs.reserve(n);
+	}
+	void push_back(Genome genome, long long cost) {
+		genomes.push_back(std::move(genome));
+		costs.push_back(cost);
+	}
+	// Overwrite individual i
+	void replace(std::size_t i, Genome genome, long long cost) {
+		genomes[i] = std::move(genome);
+		costs[i] = cost;
+	}
+	// Swap child i of offspring into slot, leaving the displaced individual in the child's place, and log it
+	void admit(std::size_t slot, Population& offspring, std::size_t i) {
+		std::swap(genomes[slot], offspring.genomes[i]);
+		costs[slot] = offspring.costs[i];
+		exchanges.emplace_back(slot, i);
+	}
+
+	// Index of the individual with the largest cost
+	std::size_t best_index() const {
+		std::size_t best = 0;
+		for (std::size_t i = 1; i < costs.size(); i++) {
+			if (costs[i] > costs[best])
+				best = i;
+		}
+		return best;
+	}
+	// Index of the individual with the smallest cost
+	std::size_t worst_index() const {
+		std::size_t worst = 0;
+		for (std::size_t i = 1; i < costs.size(); i++) {
+			if (costs[i] < costs[worst])
+				worst = i;
+		}
+		return worst;
+	}
+};
+
+} // namespace maxcut
@@ -0,0 +1,121 @@
+#pragma once
+// Locality-improving vertex renumbering
+// Input vertex ids are arbitrary, so a vertex's neighbours are scattered over the genome words, the CSR
+// arrays and the sliced evaluator's vertex planes. Renumbering in BFS or reverse Cuthill-McKee order puts
+// neighbours at nearby ids (RCM also keeps the bandwidth small); sorting by degree groups the hubs. The
+// renumbered graph's edges are sorted by (smaller, larger) endpoint, so the evaluators sweep their vertex
+// data nearly in order, and prefix / one-point crossovers cut the genome along connected pieces.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <vector>
+#include "graph.h"
+
+namespace maxcut {
+
+enum class Ordering { none, bfs, rcm, degree };
+
+// "none", "bfs", "rcm" or "degree"; false for anything else
+inline bool parse_ordering(const std::string& name, Ordering& ordering) {
+	if (name == "none")
+		ordering = Ordering::none;
+	else if (name == "bfs")
+		ordering = Ordering::bfs;
+	else if (name == "rcm")
+		ordering = Ordering::rcm;
+	else if (name == "degree")
+		ordering = Ordering::degree;
+	else
+		return false;
+	return true;
+}
+
+// order[i] is the vertex placed at new id i
+inline std::vector<int> vertex_order(const Graph& graph, Ordering ordering) {
+	std::size_t n = std::size_t(graph.size());
+	std::vector<int> order(n);
+	std::iota(order.begin(), order.end(), 0);
+	if (ordering == Ordering::none)
+		return order;
+	if (ordering == Ordering::degree) {
+		std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return graph.degree(a) > graph.degree(b); });
+		return order;
+	}
+
+	// BFS from a low-degree vertex of every component; RCM visits neighbours by increasing degree and reverses
+	bool rcm = ordering == Ordering::rcm;
+	std::vector<int> by_degree(order);
+	std::stable_sort(by_degree.begin(), by_degree.end(), [&](int a, int b) { return graph.degree(a) < graph.degree(b); });
+	std::vector<std::uint8_t> seen(n, 0);
+	std::vector<int> neighbours;
+	order.clear();
+	for (int root : by_degree) {
+		if (seen[root])
+			continue;
+		std::size_t head = order.size();
+		seen[root] = 1;
+		order.push_back(root);
+		while (head < order.size()) {
+			int v = order[head++];
+			neighbours.clear();
+			for (int k = graph.offset[v]; k < graph.offset[v + 1]; k++) {
+				int u = graph.adj[k];
+				if (!seen[u]) {
+					seen[u] = 1;
+					neighbours.push_back(u);
+				}
+			}
+			if (rcm)
+				std::stable_sort(neighbours.begin(), neighbours.end(),
+					[&](int a, int b) { return graph.degree(a) < graph.degree(b); });
+			order.insert(order.end(), neighbours.begin(), neighbours.end());
+		}
+	}
+	if (rcm)
+		std::reverse(order.begin(), order.end());
+	return order;
+}
+
+// A graph renumbered by an ordering, with the map back
+class Renumbering {
+private:
+	std::vector<int> order; // new id -> vertex of the source graph
+
+public:
+	Graph graph; // the renumbered graph, edges sorted by (smaller, larger) endpoint
+
+	void apply(const Graph& source, Ordering ordering) {
+		order = vertex_order(source, ordering);
+		std::vector<int> position(order.size()); // vertex of the source graph -> new id
+		for (std::size_t i = 0; i < order.size(); i++)
+			position[std::size_t(order[i])] = int(i);
+		std::vector<Edge> edges;
+		edges.reserve(source.edge_count());
+		for (const Edge& e : source.edges) {
+			int a = position[std::size_t(e.u)], b = position[std::size_t(e.v)];
+			edges.push_back(Edge{ std::min(a, b), std::max(a, b), e.w });
+		}
+		std::sort(edges.begin(), edges.end(), [](const Edge& x, const Edge& y) { return x.u != y.u ? x.u < y.u : x.v < y.v; });
+		graph = Graph(source.size(), std::move(edges));
+	}
+
+	// Largest |new id - new id| over the edges
+	int bandwidth() const {
+		int b = 0;
+		for (const Edge& e : graph.edges)
+			b = std::max(b, e.v - e.u);
+		return b;
+	}
+
+	// Turn a partition of the renumbered graph (0 / 1 per new id) into one of the source graph, in place
+	void restore(std::vector<std::uint8_t>& sides) const {
+		std::vector<std::uint8_t> source(order.size(), 0);
+		for (std::size_t i = 0; i < order.size() && i < sides.size(); i++)
+			source[std::size_t(order[i])] = sides[i];
+		sides.swap(source);
+	}
+};
+
+} // namespace maxcut
@@ -0,0 +1,239 @@
+#pragma once
+// Replacement policies
+// Every policy provides
+//   std::size_t operator()(Population& pop, Population& offspring, Rng&)
+// which merges the evaluated offspring into pop and returns how many children entered it. Children enter by
+// swapping places with the individual they displace, logged in pop.exchanges (Population::admit), or pop.renewed
+// is set when the whole population is swapped out; each child is swapped at most once.
+// offspring may be left in any state; the engine overwrites it next generation.
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "genome.h"
+
+namespace maxcut {
+
+// The offspring become the next population (20211343, 20211291, 20211301)
+class GenerationalReplacement {
+public:
+	template <class Pop>
+	std::size_t operator()(Pop& pop, Pop& offspring, Rng&) const {
+		std::swap(pop.genomes, offspring.genomes); // the old genomes are reused as child buffers
+		std::swap(pop.costs, offspring.costs);
+		pop.renewed = true;
+		return pop.size();
+	}
+};
+
+// Truncation survivor selection over parallel genome / cost arrays; keeps mu = genomes.size() individuals.
+//   plus  (mu + lambda): the best mu of parents and children, children first on equal costs
+//   comma (mu, lambda): the best mu of the children; with fewer than mu children it falls back to plus
+// Only cached costs are compared, the top mu is found with nth_element (no full sort) and survivors are
+// swapped into place, so no genome is copied; children that did not survive are left in `children`.
+// Returns how many children entered; each (slot, child) swap is appended to exchanges when given.
+template <class Genome>
+std::size_t truncate(std::vector<Genome>& genomes, std::vector<long long>& costs,
+	std::vector<Genome>& children, std::vector<long long>& child_costs, bool plus,
+	std::vector<std::pair<std::size_t, std::size_t>>* exchanges = nullptr) {
+	std::size_t mu = genomes.size(), lambda = children.size();
+	if (!plus && lambda >= mu) {
+		std::vector<std::size_t> order(lambda);
+		for (std::size_t i = 0; i < lambda; i++)
+			order[i] = i;
+		if (lambda > mu)
+			std::nth_element(order.begin(), order.begin() + mu, order.end(),
+				[&](std::size_t a, std::size_t b) { return child_costs[a] > child_costs[b]; });
+		for (std::size_t i = 0; i < mu; i++) {
+			std::swap(genomes[i], children[order[i]]);
+			costs[i] = child_costs[order[i]];
+			if (exchanges != nullptr)
+				exchanges->emplace_back(i, order[i]);
+		}
+		return mu;
+	}
+
+	// merged index k: parent k for k < mu, child k - mu otherwise
+	std::vector<std::size_t> order(mu + lambda);
+	for (std::size_t k = 0; k < order.size(); k++)
+		order[k] = k;
+	auto key = [&](std::size_t k) { return k < mu ? costs[k] : child_costs[k - mu]; };
+	if (lambda > 0)
+		std::nth_element(order.begin(), order.begin() + mu, order.end(), [&](std::size_t a, std::size_t b) {
+			long long ka = key(a), kb = key(b);
+			return ka != kb ? ka > kb : a > b;
+		});
+	// children in the top mu take the slots of the parents outside it (there are as many of each)
+	std::size_t entered = 0;
+	for (std::size_t i = 0, j = mu; i < mu; i++) {
+		if (order[i] < mu)
+			continue;
+		while (order[j] >= mu)
+			j++;
+		std::size_t slot = order[j++], child = order[i] - mu;
+		std::swap(genomes[slot], children[child]);
+		costs[slot] = child_costs[child];
+		if (exchanges != nullptr)
+			exchanges->emplace_back(slot, child);
+		entered++;
+	}
+	return entered;
+}
+
+// Each child replaces the current worst individual if it is better (20211327)
+class ReplaceWorstIfBetter {
+public:
+	template <class Pop>
+	std::size_t operator()(Pop& pop, Pop& offspring, Rng&) const {
+		std::size_t accepted = 0;
+		for (std::size_t i = 0; i < offspring.size(); i++) {
+			std::size_t worst = pop.worst_index();
+			if (offspring.costs[i] > pop.costs[worst]) {
+				pop.admit(worst, offspring, i);
+				accepted++;
+			}
+		}
+		return accepted;
+	}
+};
+
+// Each child replaces a random individual whose cost is a little smaller:
+// within [cost - thresh - 3, cost - 1], thresh = max(20% of the cost range, 5). Otherwise the child is dropped (basic GA)
+class NearCostReplacement {
+private:
+	double ratio; // thresh as a fraction of the cost range
+	long long min_thresh; // lower bound of thresh
+	std::vector<std::size_t> candidates; // scratch
+
+public:
+	explicit NearCostReplacement(double ratio = 0.2, long long min_thresh = 5) : ratio(ratio), min_thresh(min_thresh) {}
+
+	template <class Pop>
+	std::size_t operator()(Pop& pop, Pop& offspring, Rng& rng) {
+		auto range = std::minmax_element(pop.costs.begin(), pop.costs.end());
+		long long thresh = std::max((long long)(double(*range.second - *range.first) * ratio), min_thresh);
+		std::size_t accepted = 0;
+		for (std::size_t i = 0; i < offspring.size(); i++) {
+			long long cost = offspring.costs[i];
+			candidates.clear();
+			for (std::size_t j = 0; j < pop.size(); j++) {
+				if (pop.costs[j] < cost && pop.costs[j] >= cost - thresh - 3)
+					candidates.push_back(j);
+			}
+			if (candidates.empty())
+				continue;
+			std::size_t victim = candidates[std::uniform_int_distribution<std::size_t>(0, candidates.size() - 1)(rng)];
+			pop.admit(victim, offspring, i);
+			accepted++;
+		}
+		return accepted;
+	}
+};
+
+// Deterministic crowding: each child competes with the parent whose cut is closer to its own
+// (Hamming distance up to complement) and takes its place if it is better. Needs offspring.parents.
+class DeterministicCrowding {
+public:
+	template <class Pop>
+	std::size_t operator()(Pop& pop, Pop& offspring, Rng&) const {
+		std::size_t accepted = 0;
+		for (std::size_t i = 0; i < offspring.size(); i++) {
+			std::size_t a = offspring.parents[i].first, b = offspring.parents[i].second;
+			std::size_t target = cut_distance(offspring.genomes[i], pop.genomes[a])
+				<= cut_distance(offspring.genomes[i], pop.genomes[b]) ? a : b;
+			if (offspring.costs[i] > pop.costs[target]) {
+				pop.admit(target, offspring, i);
+				accepted++;
+			}
+		}
+		return accepted;
+	}
+};
+
+// Restricted tournament replacement: each child is compared with the closest of `window` random individuals
+// and replaces it if it is better; window 0 means max(2, P / 20)
+class RestrictedTournamentReplacement {
+private:
+	std::size_t window; // sample size
+
+public:
+	explicit RestrictedTournamentReplacement(std::size_t window = 0) : window(window) {}
+
+	template <class Pop>
+	std::size_t operator()(Pop& pop, Pop& offspring, Rng& rng) const {
+		std::size_t w = window ? window : std::max<std::size_t>(2, pop.size() / 20);
+		w = std::min(w, pop.size());
+		std::uniform_int_distribution<std::size_t> dis(0, pop.size() - 1);
+		std::size_t accepted = 0;
+		for (std::size_t i = 0; i < offspring.size(); i++) {
+			std::size_t nearest = dis(rng);
+			std::size_t nearest_distance = cut_distance(offspring.genomes[i], pop.genomes[nearest]);
+			for (std::size_t k = 1; k < w && nearest_distance > 0; k++) {
+				std::size_t j = dis(rng);
+				std::size_t d = cut_distance(offspring.genomes[i], pop.genomes[j]);
+				if (d < nearest_distance) {
+					nearest = j;
+					nearest_distance = d;
+				}
+			}
+			if (offspring.costs[i] > pop.costs[nearest]) {
+				pop.admit(nearest, offspring, i);
+				accepted++;
+			}
+		}
+		return accepted;
+	}
+};
+
+// Survivor selection chosen at run time (see parse_survivors)
+enum class Survivors { standard, plus, comma, crowding, restricted };
+
+// "default" (the variant's own replacement), "plus", "comma", "crowding" or "rtr"; false for anything else
+inline bool parse_survivors(const std::string& name, Survivors& survivors) {
+	if (name == "default")
+		survivors = Survivors::standard;
+	else if (name == "plus")
+		survivors = Survivors::plus;
+	else if (name == "comma")
+		survivors = Survivors::comma;
+	else if (name == "crowding")
+		survivors = Survivors::crowding;
+	else if (name == "rtr")
+		survivors = Survivors::restricted;
+	else
+		return false;
+	return true;
+}
+
+// The variant's own replacement (Standard), (mu + lambda), (mu, lambda), deterministic crowding or
+// restricted tournament replacement
+template <class Standard>
+class SurvivorReplacement {
+private:
+	Survivors survivors;
+	Standard standard;
+
+public:
+	explicit SurvivorReplacement(Standard standard, Survivors survivors = Survivors::standard)
+		: survivors(survivors), standard(standard) {}
+
+	template <class Pop>
+	std::size_t operator()(Pop& pop, Pop& offspring, Rng& rng) {
+		switch (survivors) {
+		case Survivors::plus:
+		case Survivors::comma:
+			return truncate(pop.genomes, pop.costs, offspring.genomes, offspring.costs, survivors == Survivors::plus,
+				&pop.exchanges);
+		case Survivors::crowding:
+			return DeterministicCrowding()(pop, offspring, rng);
+		case Survivors::restricted:
+			return RestrictedTournamentReplacement()(pop, offspring, rng);
+		default:
+			return standard(pop, offspring, rng);
+		}
+	}
+};
+
+} // namespace maxcut
@@ -0,0 +1,198 @@
+#pragma once
+// Selection policies
+// Every policy provides
+//   void prepare(const Population&)                          once per generation, before any parents()
+//   std::pair<size_t, size_t> parents(const Population&, Rng&) indices of the two parents
+// and compares the cached costs only, so selection never evaluates a genome.
+#include <algorithm>
+#include <cstddef>
+#include <random>
+#include <utility>
+#include <vector>
+#include "genome.h"
+#include "pair_window.h"
+#include "tournament.h"
+
+namespace maxcut {
+
+// Tournament among `size` distinct individuals: the best wins with probability p_best, otherwise the worst (20211343)
+// The first parents() call of a generation runs 2 P tournaments in one batch; later calls hand out their winners.
+class TournamentSelection {
+private:
+	std::size_t size; // entrants per tournament
+	double p_best; // probability that the best entrant wins
+	TournamentBatch batch;
+	std::vector<std::size_t> best, worst, winners; // batch results
+	std::size_t next = 0; // next unused winner
+
+public:
+	explicit TournamentSelection(std::size_t size = 2, double p_best = 0.7) : size(size), p_best(p_best) {}
+
+	template <class Pop>
+	void prepare(const Pop&) {
+		winners.clear();
+		next = 0;
+	}
+
+	template <class Pop>
+	std::pair<std::size_t, std::size_t> parents(const Pop& pop, Rng& rng) {
+		if (next + 2 > winners.size()) {
+			std::size_t count = 2 * pop.size();
+			best.resize(count);
+			worst.resize(count);
+			winners.resize(count);
+			batch.run(pop.costs.data(), pop.size(), size, count, rng, best.data(), worst.data());
+			std::uniform_real_distribution<double> dis(0, 1);
+			for (std::size_t t = 0; t < count; t++)
+				winners[t] = dis(rng) < p_best ? best[t] : worst[t];
+			next = 0;
+		}
+		next += 2;
+		return { winners[next - 2], winners[next - 1] };
+	}
+};
+
+// Tournament whose size is a fraction of the vertex count: with probability p_best the best entrant wins,
+// otherwise a random entrant (20211291). Batched like TournamentSelection.
+class RatioTournament {
+private:
+	double ratio; // entrants per vertex
+	double p_best; // probability of taking the best entrant
+	std::size_t size = 1; // entrants, fixed in prepare()
+	TournamentBatch batch;
+	std::vector<std::size_t> best, winners; // batch results
+	std::size_t next = 0; // next unused winner
+
+public:
+	explicit RatioTournament(double ratio = 0.14, double p_best = 0.6) : ratio(ratio), p_best(p_best) {}
+
+	template <class Pop>
+	void prepare(const Pop& pop) {
+		std::size_t n = pop.empty() ? 1 : std::size_t(double(pop.genomes[0].size()) * ratio);
+		size = std::max<std::size_t>(1, std::min(n, pop.size())); // more entrants than individuals never ends
+		winners.clear();
+		next = 0;
+	}
+
+	template <class Pop>
+	std::pair<std::size_t, std::size_t> parents(const Pop& pop, Rng& rng) {
+		if (next + 2 > winners.size()) {
+			std::size_t count = 2 * pop.size();
+			winners.resize(count);
+			// a random entrant of a random tournament is a uniformly random individual, so only the
+			// picks that take the best entrant need a tournament
+			std::uniform_real_distribution<double> dis(0, 1);
+			std::uniform_int_distribution<std::size_t> any(0, pop.size() - 1);
+			std::size_t n_best = 0;
+			for (std::size_t t = 0; t < count; t++) {
+				bool take_best = dis(rng) < p_best;
+				winners[t] = take_best ? pop.size() : any(rng); // pop.size(): filled from the batch below
+				n_best += take_best;
+			}
+			best.resize(n_best);
+			batch.run(pop.costs.data(), pop.size(), size, n_best, rng, best.data(), nullptr);
+			for (std::size_t t = 0, k = 0; t < count; t++) {
+				if (winners[t] == pop.size())
+					winners[t] = best[k++];
+			}
+			next = 0;
+		}
+		next += 2;
+		return { winners[next - 2], winners[next - 1] };
+	}
+};
+
+// Knockout bracket over 2^3 .. 2^5 random entrants; each match goes to the higher cost with probability p_high (basic GA)
+class BracketTournament {
+private:
+	double p_high; // probability that the higher cost wins a match
+	std::vector<std::size_t> bracket; // scratch
+
+public:
+	explicit BracketTournament(double p_high = 0.5) : p_high(p_high) {}
+
+	template <class Pop>
+	void prepare(const Pop&) {}
+
+	template <class Pop>
+	std::size_t pick(const Pop& pop, Rng& rng) {
+		std::size_t n = std::size_t(1) << std::uniform_int_distribution<int>(3, 5)(rng);
+		std::uniform_int_distribution<std::size_t> dis(0, pop.size() - 1);
+		std::bernoulli_distribution high(p_high);
+		bracket.resize(n);
+		for (auto& i : bracket)
+			i = dis(rng);
+		// winner of each match moves to the left slot; the champion ends at bracket[0]
+		for (std::size_t step = 1; step < n; step *= 2) {
+			for (std::size_t j = 0; j < n; j += 2 * step) {
+				std::size_t a = bracket[j], b = bracket[j + step];
+				bool a_higher = pop.costs[a] >= pop.costs[b];
+				bracket[j] = (high(rng) == a_higher) ? a : b;
+			}
+		}
+		return bracket[0];
+	}
+
+	template <class Pop>
+	std::pair<std::size_t, std::size_t> parents(const Pop& pop, Rng& rng) {
+		std::size_t a = pick(pop, rng);
+		return { a, pick(pop, rng) };
+	}
+};
+
+// Roulette wheel over f = (c - c_worst) + (c_best - c_worst) / (k - 1) (20211327)
+class RouletteSelection {
+private:
+	int k; // selection pressure
+	std::vector<double> cumulative; // prefix sums of f
+
+public:
+	explicit RouletteSelection(int k = 3) : k(k) {}
+
+	template <class Pop>
+	void prepare(const Pop& pop) {
+		long long cw = *std::min_element(pop.costs.begin(), pop.costs.end());
+		long long cb = *std::max_element(pop.costs.begin(), pop.costs.end());
+		double base = double(cb - cw) / double(k - 1);
+		double sum = 0;
+		cumulative.resize(pop.size());
+		for (std::size_t i = 0; i < pop.size(); i++) {
+			sum += double(pop.costs[i] - cw) + base;
+			cumulative[i] = sum;
+		}
+	}
+
+	template <class Pop>
+	std::size_t pick(const Pop& pop, Rng& rng) {
+		if (cumulative.empty() || cumulative.back() <= 0) // every cost is the same
+			return std::uniform_int_distribution<std::size_t>(0, pop.size() - 1)(rng);
+		double point = std::uniform_real_distribution<double>(0, cumulative.back())(rng);
+		std::size_t i = std::size_t(std::upper_bound(cumulative.begin(), cumulative.end(), point) - cumulative.begin());
+		return std::min(i, pop.size() - 1);
+	}
+
+	template <class Pop>
+	std::pair<std::size_t, std::size_t> parents(const Pop& pop, Rng& rng) {
+		std::size_t a = pick(pop, rng);
+		return { a, pick(pop, rng) };
+	}
+};
+
+// Two random parents whose cost difference is at most `window` times the largest cost (20211301)
+// Sampled without rejection from a cost-sorted index built in prepare(), see pair_window.h
+class WindowPairSelection {
+private:
+	double window; // allowed difference as a fraction of the largest cost
+	PairWindow pairs; // admissible pairs of the current population
+
+public:
+	explicit WindowPairSelection(double window = 0.5) : window(window) {}
+
+	template <class Pop>
+	void prepare(const Pop& pop) { pairs.build(pop.costs.data(), pop.size(), window); }
+
+	template <class Pop>
+	std::pair<std::size_t, std::size_t> parents(const Pop&, Rng& rng) { return pairs.sample(rng); }
+};
+
+} // namespace maxcut
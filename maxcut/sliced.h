@@ -0,0 +1,240 @@
+#pragma once
+// Bit-sliced cut evaluation of a whole batch of partitions in one pass over the edges
+// The batch is stored gene-major: sides[v] holds the side of vertex v in 64 partitions (256 with AVX2), one per
+// bit lane, so side[u] ^ side[v] tells for every lane at once whether edge (u, v) is cut. The per-lane cut weights
+// are kept as vertical binary counters (planes[k] holds bit k of every lane's sum); adding an edge of weight w
+// ripples the cut mask into the planes of the set bits of w. The edges are read from a CompactEdges copy
+// (weights.h): an unweighted graph streams endpoints only and adds every cut mask to plane 0.
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "graph.h"
+#include "weights.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace maxcut {
+
+// Index of the lowest set bit; x != 0
+inline int lowest_bit64(std::uint64_t x) {
+#if defined(_MSC_VER) && defined(_M_X64)
+	unsigned long i;
+	_BitScanForward64(&i, x);
+	return int(i);
+#elif defined(__GNUC__)
+	return __builtin_ctzll(x);
+#else
+	int i = 0;
+	while (!(x & 1)) {
+		x >>= 1;
+		i++;
+	}
+	return i;
+#endif
+}
+
+// In-place transpose of a 64 x 64 bit matrix: bit j of a[i] <-> bit i of a[j]
+inline void transpose64(std::uint64_t a[64]) {
+	std::uint64_t m = 0x00000000FFFFFFFFULL;
+	for (int j = 32; j != 0; j >>= 1, m ^= (m << j)) {
+		for (int k = 0; k < 64; k = ((k | j) + 1) & ~j) {
+			std::uint64_t t = ((a[k] >> j) ^ a[k | j]) & m;
+			a[k] ^= t << j;
+			a[k | j] ^= t;
+		}
+	}
+}
+
+// One bit per partition of the batch
+#ifdef __AVX2__
+struct SliceLanes {
+	static constexpr std::size_t words = 4;
+	__m256i x;
+
+	static SliceLanes zero() { return { _mm256_setzero_si256() }; }
+	static SliceLanes load(const std::uint64_t* p) { return { _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)) }; }
+	void store(std::uint64_t* p) const { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+	bool any() const { return !_mm256_testz_si256(x, x); }
+	friend SliceLanes operator^(SliceLanes a, SliceLanes b) { return { _mm256_xor_si256(a.x, b.x) }; }
+	friend SliceLanes operator&(SliceLanes a, SliceLanes b) { return { _mm256_and_si256(a.x, b.x) }; }
+	friend SliceLanes operator|(SliceLanes a, SliceLanes b) { return { _mm256_or_si256(a.x, b.x) }; }
+};
+#else
+struct SliceLanes {
+	static constexpr std::size_t words = 1;
+	std::uint64_t x;
+
+	static SliceLanes zero() { return { 0 }; }
+	static SliceLanes load(const std::uint64_t* p) { return { *p }; }
+	void store(std::uint64_t* p) const { *p = x; }
+	bool any() const { return x != 0; }
+	friend SliceLanes operator^(SliceLanes a, SliceLanes b) { return { a.x ^ b.x }; }
+	friend SliceLanes operator&(SliceLanes a, SliceLanes b) { return { a.x & b.x }; }
+	friend SliceLanes operator|(SliceLanes a, SliceLanes b) { return { a.x | b.x }; }
+};
+#endif
+
+// Transpose up to 64 * W genomes into bit-sliced vertex words, 64 genomes x 64 genes at a time: lanes 64 l ..
+// 64 l + 63 of vertex v go to sides[v * stride + l]. sides must be zeroed.
+template <class Genome>
+void transpose_genomes(const Genome* genomes, std::size_t count, std::size_t n, std::uint64_t* sides, std::size_t stride) {
+	std::uint64_t block[64];
+	for (std::size_t l = 0; l * 64 < count; l++) {
+		std::size_t c = std::min<std::size_t>(64, count - l * 64);
+		for (std::size_t i = 0; i * 64 < n; i++) {
+			for (std::size_t j = 0; j < 64; j++)
+				block[j] = (j < c) ? genomes[l * 64 + j].word(i) : 0;
+			transpose64(block);
+			std::size_t genes = std::min<std::size_t>(64, n - i * 64);
+			for (std::size_t b = 0; b < genes; b++)
+				sides[(i * 64 + b) * stride + l] = block[b];
+		}
+	}
+}
+
+// Per-lane cut weights of one group of lanes, as vertical binary counters of the positive and negative weights
+class SliceCounters {
+public:
+	static constexpr std::size_t W = SliceLanes::words;
+
+private:
+	std::size_t planes = 1; // counter bits: enough for the total absolute weight
+	std::vector<std::uint64_t> pos, neg; // planes * W words each
+
+public:
+	// Counters for sums of absolute weight up to total
+	explicit SliceCounters(std::uint64_t total = 0) {
+		while (planes < 63 && (total >> planes) != 0)
+			planes++;
+		planes++; // room for the last carry
+	}
+
+	void clear() {
+		pos.assign(planes * W, 0);
+		neg.assign(planes * W, 0);
+	}
+
+	// Add weight w to every lane set in x
+	void add(SliceLanes x, long long w) {
+		std::uint64_t* counter = (w < 0 ? neg.data() : pos.data());
+		for (std::uint64_t a = std::uint64_t(w < 0 ? -w : w); a != 0; a &= a - 1)
+			ripple(counter, std::size_t(lowest_bit64(a)), x);
+	}
+
+	// Sums of lanes 0 .. count - 1 into costs
+	void read(std::size_t count, long long* costs) const {
+		std::fill(costs, costs + count, 0);
+		for (std::size_t k = 0; k < planes; k++) {
+			for (std::size_t l = 0; l * 64 < count; l++) {
+				for (std::uint64_t bits = pos[k * W + l]; bits != 0; bits &= bits - 1)
+					costs[l * 64 + lowest_bit64(bits)] += (long long)1 << k;
+				for (std::uint64_t bits = neg[k * W + l]; bits != 0; bits &= bits - 1)
+					costs[l * 64 + lowest_bit64(bits)] -= (long long)1 << k;
+			}
+		}
+	}
+
+private:
+	// Add the mask carry to the counter at plane b
+	void ripple(std::uint64_t* counter, std::size_t b, SliceLanes carry) {
+		for (std::uint64_t* p = counter + b * W; ; p += W) {
+			SliceLanes c = SliceLanes::load(p);
+			(c ^ carry).store(p);
+			carry = c & carry;
+			if (!carry.any())
+				return;
+		}
+	}
+};
+
+// Batch cut evaluator over an edge list (0-based endpoints). Copies share the compact edges but not the scratch
+// buffers, so one object must not be used by two threads at once.
+class SlicedCut {
+public:
+	static constexpr std::size_t W = SliceLanes::words; // 64-bit words per vertex
+	static constexpr std::size_t lanes = 64 * W; // partitions evaluated per pass
+
+private:
+	std::size_t n; // vertex count
+	std::shared_ptr<const CompactEdges> edges;
+	std::vector<std::uint64_t> sides; // sides[v * W + l]: lanes 64 l .. 64 l + 63 of vertex v
+	SliceCounters counters;
+
+public:
+	SlicedCut(std::size_t n, std::shared_ptr<const CompactEdges> edges) : n(n), edges(std::move(edges)) {
+		counters = SliceCounters(this->edges->edge_w.visit([&](auto w) {
+			std::uint64_t sum = 0;
+			for (std::size_t i = 0; i < this->edges->size(); i++)
+				sum += std::uint64_t(w[i] < 0 ? -(long long)w[i] : (long long)w[i]);
+			return sum;
+		}));
+	}
+	SlicedCut(std::size_t n, const std::vector<Edge>& edges) : SlicedCut(n, std::make_shared<const CompactEdges>(edges)) {}
+	explicit SlicedCut(const Graph& graph) : SlicedCut(std::size_t(graph.size()), graph.edges) {}
+
+	// Cut weights of genomes[0 .. count) into costs (any genome type with word(i) / word_count())
+	template <class Genome>
+	void operator()(const Genome* genomes, std::size_t count, long long* costs) {
+		for (std::size_t first = 0; first < count; first += lanes) {
+			std::size_t c = std::min(lanes, count - first);
+			sides.assign(n * W, 0);
+			transpose_genomes(genomes + first, c, n, sides.data(), W);
+			pass(c, costs + first, nullptr);
+		}
+	}
+
+	// Same for partitions given as side(j, v) -> bool for j < count, v < n. crossing[j] (if not null) tells whether
+	// partition j cuts at least one edge, whatever the weights.
+	template <class Side>
+	void evaluate(std::size_t count, Side side, long long* costs, bool* crossing = nullptr) {
+		for (std::size_t first = 0; first < count; first += lanes) {
+			std::size_t c = std::min(lanes, count - first);
+			sides.assign(n * W, 0);
+			for (std::size_t v = 0; v < n; v++) {
+				for (std::size_t j = 0; j < c; j++) {
+					if (side(first + j, v))
+						sides[v * W + j / 64] |= std::uint64_t(1) << (j % 64);
+				}
+			}
+			pass(c, costs + first, crossing != nullptr ? crossing + first : nullptr);
+		}
+	}
+
+private:
+	// Add every edge's cut mask to the counters; returns the union of the masks
+	template <class Weights>
+	SliceLanes accumulate(Weights weights) {
+		SliceLanes any_cut = SliceLanes::zero();
+		const EdgeEnds* ends = edges->ends.data();
+		for (std::size_t i = 0, m = edges->size(); i < m; i++) {
+			SliceLanes x = SliceLanes::load(&sides[std::size_t(ends[i].u) * W]) ^ SliceLanes::load(&sides[std::size_t(ends[i].v) * W]);
+			any_cut = any_cut | x;
+			if (x.any())
+				counters.add(x, weights[i]);
+		}
+		return any_cut;
+	}
+
+	// One pass over the edges for the loaded sides, then read the first count lanes out of the counters
+	void pass(std::size_t count, long long* costs, bool* crossing) {
+		counters.clear();
+		SliceLanes any_cut = edges->edge_w.visit([&](auto weights) { return accumulate(weights); });
+		counters.read(count, costs);
+		if (crossing != nullptr) {
+			std::uint64_t words[W];
+			any_cut.store(words);
+			for (std::size_t j = 0; j < count; j++)
+				crossing[j] = (words[j / 64] >> (j % 64)) & 1;
+		}
+	}
+};
+
+} // namespace maxcut
@@ -0,0 +1,98 @@
+#pragma once
+// Batch tournament kernel over a cached cost column
+// A generation's tournaments are drawn in one call: entrants come from a partial Fisher-Yates shuffle of a
+// persistent index permutation (distinct, O(size) per tournament), their costs are gathered into a contiguous
+// buffer and the winner is found with one argmax/argmin scan (4 costs per step with AVX2).
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace maxcut {
+
+// Indices of the largest and the smallest of v[0 .. n), n >= 1; the first one on ties
+inline std::pair<std::size_t, std::size_t> arg_max_min(const long long* v, std::size_t n) {
+	std::size_t hi = 0, lo = 0, i = 1;
+#ifdef __AVX2__
+	if (n >= 8) {
+		__m256i vmax = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v));
+		__m256i vmin = vmax;
+		__m256i idx = _mm256_setr_epi64x(0, 1, 2, 3);
+		__m256i imax = idx, imin = idx;
+		const __m256i four = _mm256_set1_epi64x(4);
+		for (i = 4; i + 4 <= n; i += 4) {
+			__m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(v + i));
+			idx = _mm256_add_epi64(idx, four);
+			__m256i gt = _mm256_cmpgt_epi64(x, vmax);
+			__m256i lt = _mm256_cmpgt_epi64(vmin, x);
+			vmax = _mm256_blendv_epi8(vmax, x, gt);
+			imax = _mm256_blendv_epi8(imax, idx, gt);
+			vmin = _mm256_blendv_epi8(vmin, x, lt);
+			imin = _mm256_blendv_epi8(imin, idx, lt);
+		}
+		alignas(32) long long mv[4], mi[4], nv[4], ni[4];
+		_mm256_store_si256(reinterpret_cast<__m256i*>(mv), vmax);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(mi), imax);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(nv), vmin);
+		_mm256_store_si256(reinterpret_cast<__m256i*>(ni), imin);
+		hi = std::size_t(mi[0]);
+		lo = std::size_t(ni[0]);
+		for (int k = 1; k < 4; k++) {
+			if (mv[k] > v[hi] || (mv[k] == v[hi] && std::size_t(mi[k]) < hi))
+				hi = std::size_t(mi[k]);
+			if (nv[k] < v[lo] || (nv[k] == v[lo] && std::size_t(ni[k]) < lo))
+				lo = std::size_t(ni[k]);
+		}
+	}
+#endif
+	for (; i < n; i++) {
+		if (v[i] > v[hi])
+			hi = i;
+		if (v[i] < v[lo])
+			lo = i;
+	}
+	return { hi, lo };
+}
+
+class TournamentBatch {
+private:
+	std::vector<std::uint32_t> perm; // permutation of 0 .. P-1; a shuffled prefix is one tournament's entrants
+	std::vector<long long> gathered; // entrants' costs, contiguous for arg_max_min()
+
+public:
+	// Run `count` tournaments of `size` distinct entrants (at most P) over costs[0 .. P).
+	// best[t] / worst[t] receive the best / worst entrant of tournament t; either may be null.
+	template <class Urbg>
+	void run(const long long* costs, std::size_t P, std::size_t size, std::size_t count, Urbg& rng,
+		std::size_t* best, std::size_t* worst) {
+		if (size > P)
+			size = P;
+		if (size == 0)
+			size = 1;
+		if (perm.size() != P) {
+			perm.resize(P);
+			for (std::size_t i = 0; i < P; i++)
+				perm[i] = std::uint32_t(i);
+		}
+		gathered.resize(size);
+		for (std::size_t t = 0; t < count; t++) {
+			for (std::size_t k = 0; k < size; k++) {
+				std::size_t j = std::uniform_int_distribution<std::size_t>(k, P - 1)(rng);
+				std::swap(perm[k], perm[j]);
+				gathered[k] = costs[perm[k]];
+			}
+			std::pair<std::size_t, std::size_t> m = arg_max_min(gathered.data(), size);
+			if (best != nullptr)
+				best[t] = perm[m.first];
+			if (worst != nullptr)
+				worst[t] = perm[m.second];
+		}
+	}
+};
+
+} // namespace maxcut
@@ -0,0 +1,210 @@
+#pragma once
+// The team's GA implementations as GeneticEngine policy combinations
+//   basic          20191130/basic GA      bracket tournament, uniform 50%, near-cost steady-state replacement
+//   20211343       20211343_pure.cpp      2-tournament (70% best), half swap, flip 1%, generational
+//   20211291       PureGAProject.cpp      0.14 V tournament (60% best), fitter 3/4 prefix (80%), flip 5%, generational
+//   20211301       GA_20211301.cpp        cost-window pairs (50%), uniform 60%, ramped flips, generational
+//   20211327       Alg_Genetics8.cpp      roulette, one point, single flip 1%, replace worst if better
+//   20211327-local Alg_Genetics2_1.cpp    20211327 plus an improving single-vertex flip
+//   sa             (annealing.h)          simulated annealing chains, not a GA; same interface for main.cpp
+//   eda            (eda.h)                PBIL probability vector instead of a population
+//   ml-<variant>   (multilevel.h)         coarsen, solve the coarsest graph with <variant>, refine back up
+//   cc-<variant>   (components.h)         solve each connected component with <variant> (or ml-<variant>)
+//   exact          (exact.h)              branch and bound, provably optimal; graphs of up to 64 vertices
+//   auto                                  exact when the graph fits, basic otherwise
+// VariantOptions::survivors swaps the replacement of any variant for truncation or crowding (replacement.h);
+// every variant path-relinks a few elites toward its best once per population turnover (path_relinking.h).
+// Population sizes follow the originals. Things the originals did not really do (re-selecting equal parents in
+// 20211291, the never-called mutation of the basic GA) follow their design notes instead of the code.
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "annealing.h"
+#include "components.h"
+#include "crossover.h"
+#include "eda.h"
+#include "evaluator.h"
+#include "exact.h"
+#include "genetic_engine.h"
+#include "genome.h"
+#include "graph.h"
+#include "multilevel.h"
+#include "mutation.h"
+#include "replacement.h"
+#include "selection.h"
+
+namespace maxcut {
+
+template <class Genome, class Evaluator = CutEvaluator>
+using BasicGA = GeneticEngine<Genome, Evaluator, BracketTournament, UniformCrossover, FlipMutation, SurvivorReplacement<NearCostReplacement>>;
+template <class Genome, class Evaluator = CutEvaluator>
+using GA20211343 = GeneticEngine<Genome, Evaluator, TournamentSelection, PrefixCrossover, FlipMutation, SurvivorReplacement<GenerationalReplacement>>;
+template <class Genome, class Evaluator = CutEvaluator>
+using GA20211291 = GeneticEngine<Genome, Evaluator, RatioTournament, FitterPrefixCrossover, FlipMutation, SurvivorReplacement<GenerationalReplacement>>;
+template <class Genome, class Evaluator = CutEvaluator>
+using GA20211301 = GeneticEngine<Genome, Evaluator, WindowPairSelection, UniformCrossover, RampMutation, SurvivorReplacement<GenerationalReplacement>>;
+template <class Genome, class Evaluator = CutEvaluator>
+using GA20211327 = GeneticEngine<Genome, Evaluator, RouletteSelection, OnePointCrossover, SingleFlipMutation, SurvivorReplacement<ReplaceWorstIfBetter>>;
+template <class Genome, class Evaluator = CutEvaluator>
+using GA20211327Local = GeneticEngine<Genome, Evaluator, RouletteSelection, OnePointCrossover,
+	LocalFlipMutation<SingleFlipMutation, Evaluator>, SurvivorReplacement<ReplaceWorstIfBetter>>;
+
+// Run-time choices that apply across variants
+struct VariantOptions {
+	Survivors survivors = Survivors::standard; // replacement policy, the variant's own by default
+	std::size_t relink_pairs = 4; // see EngineConfig::relink_pairs
+};
+
+// Names accepted by with_variant()
+inline std::vector<std::string> variant_names() {
+	return { "basic", "20211343", "20211291", "20211301", "20211327", "20211327-local", "sa", "eda", "auto" };
+}
+
+inline long long solve_partition(const std::string& name, const Graph& graph, std::uint64_t seed, Deadline& deadline,
+	std::vector<std::uint8_t>& sides, const VariantOptions& options);
+
+// Side of vertex v in an engine's best_genome()
+template <class Genome>
+bool side_at(const Genome& g, std::size_t v) { return g.get(v); }
+inline bool side_at(const std::vector<std::uint8_t>& sides, std::size_t v) { return sides[v] != 0; }
+
+// Build the named GA (or eda) on evaluate, for a graph of v vertices and `edges` edges, and call f(engine); false
+// when the name is not one of them. config brings the seed and the engine switches, the variant sets the sizes.
+template <class Genome, class Evaluator, class F>
+bool with_population_variant(const std::string& name, std::size_t v, std::size_t edges, const Evaluator& evaluate,
+	EngineConfig config, F&& f, const VariantOptions& options = VariantOptions()) {
+	// the variant's replacement, or the one chosen in options
+	auto survive = [&](auto standard) { return SurvivorReplacement<decltype(standard)>(standard, options.survivors); };
+
+	if (name == "basic") {
+		// pool of 2 * min(1000, 50 V), 10% of min(1000, 50 V) children per generation
+		std::size_t n_pool = std::min<std::size_t>(1000, 50 * v);
+		config.population_size = 2 * n_pool;
+		config.offspring_count = std::max<std::size_t>(1, n_pool / 10);
+		// re-choosing a gene with probability 3 / (200 V) flips it with half that probability
+		BasicGA<Genome, Evaluator> engine(v, evaluate, BracketTournament(0.5), UniformCrossover(0.5),
+			FlipMutation(1.5 / (200.0 * double(v))), survive(NearCostReplacement(0.2, 5)), config);
+		f(engine);
+	}
+	else if (name == "20211343") {
+		config.population_size = config.offspring_count = 200;
+		GA20211343<Genome, Evaluator> engine(v, evaluate, TournamentSelection(2, 0.7), PrefixCrossover(0.5),
+			FlipMutation(0.01), survive(GenerationalReplacement()), config);
+		f(engine);
+	}
+	else if (name == "20211291") {
+		config.population_size = config.offspring_count = 200;
+		GA20211291<Genome, Evaluator> engine(v, evaluate, RatioTournament(0.14, 0.6), FitterPrefixCrossover(0.75, 0.8),
+			FlipMutation(0.05), survive(GenerationalReplacement()), config);
+		f(engine);
+	}
+	else if (name == "20211301") {
+		// 10 per edge, at most 1000
+		config.population_size = config.offspring_count = std::min<std::size_t>(1000, 10 * edges);
+		GA20211301<Genome, Evaluator> engine(v, evaluate, WindowPairSelection(0.5), UniformCrossover(0.6),
+			RampMutation(0.0005, 10), survive(GenerationalReplacement()), config);
+		f(engine);
+	}
+	else if (name == "20211327" || name == "20211327-local") {
+		// 3 V solutions, one child at a time
+		config.population_size = 3 * v;
+		config.offspring_count = 1;
+		if (name == "20211327") {
+			GA20211327<Genome, Evaluator> engine(v, evaluate, RouletteSelection(3), OnePointCrossover(),
+				SingleFlipMutation(0.01), survive(ReplaceWorstIfBetter()), config);
+			f(engine);
+		}
+		else {
+			GA20211327Local<Genome, Evaluator> engine(v, evaluate, RouletteSelection(3), OnePointCrossover(),
+				LocalFlipMutation<SingleFlipMutation, Evaluator>(SingleFlipMutation(0.01), evaluate),
+				survive(ReplaceWorstIfBetter()), config);
+			f(engine);
+		}
+	}
+	else if (name == "eda") {
+		EdaConfig eda;
+		eda.seed = config.seed;
+		DistributionEngine<Genome, Evaluator> engine(v, evaluate, eda);
+		f(engine);
+	}
+	else
+		return false;
+	return true;
+}
+
+// Build the named variant for the graph and call f(engine); false for an unknown name
+template <class Genome = BitGenome, class F>
+bool with_variant(const std::string& name, const Graph& graph, std::uint64_t seed, F&& f,
+	const VariantOptions& options = VariantOptions()) {
+	std::size_t v = std::size_t(std::max(graph.size(), 1));
+	EngineConfig config;
+	config.seed = seed;
+	config.relink_pairs = options.relink_pairs;
+	if (with_population_variant<Genome>(name, v, graph.edge_count(), CutEvaluator(graph), config, f, options))
+		return true;
+
+	if (name == "sa") {
+		AnnealConfig anneal;
+		anneal.seed = seed;
+		AnnealingEngine engine(graph, anneal);
+		f(engine);
+	}
+	else if (name == "exact") {
+		if (graph.size() > ExactEngine::max_vertices)
+			return false;
+		ExactEngine engine(graph, 0, seed);
+		f(engine);
+	}
+	else if (name == "auto")
+		return with_variant<Genome>(graph.size() <= ExactEngine::max_vertices ? "exact" : "basic", graph, seed, f, options);
+	else if (name.compare(0, 3, "ml-") == 0) {
+		std::string inner = name.substr(3);
+		std::vector<std::string> names = variant_names();
+		if (std::find(names.begin(), names.end(), inner) == names.end())
+			return false;
+		MultilevelConfig multilevel;
+		multilevel.seed = seed;
+		auto solve = [inner, seed, options](const Graph& coarsest, Deadline& deadline, std::vector<std::uint8_t>& sides) {
+			return solve_partition(inner, coarsest, seed, deadline, sides, options);
+		};
+		MultilevelEngine<decltype(solve)> engine(graph, solve, multilevel);
+		f(engine);
+	}
+	else if (name.compare(0, 3, "cc-") == 0) {
+		std::string inner = name.substr(3);
+		std::string plain = inner.compare(0, 3, "ml-") == 0 ? inner.substr(3) : inner;
+		std::vector<std::string> names = variant_names();
+		if (std::find(names.begin(), names.end(), plain) == names.end())
+			return false;
+		auto solve = [inner, seed, options](const Graph& component, Deadline& deadline, std::vector<std::uint8_t>& sides) {
+			return solve_partition(inner, component, seed, deadline, sides, options);
+		};
+		ComponentEngine<decltype(solve)> engine(graph, solve);
+		f(engine);
+	}
+	else
+		return false;
+	return true;
+}
+
+// Run the named variant on graph until the deadline without an incumbent; its best partition goes to sides
+// and its cut is returned (LLONG_MIN when it found nothing or the name is unknown)
+inline long long solve_partition(const std::string& name, const Graph& graph, std::uint64_t seed, Deadline& deadline,
+	std::vector<std::uint8_t>& sides, const VariantOptions& options) {
+	long long cost = LLONG_MIN;
+	with_variant<BitGenome>(name, graph, seed, [&](auto& engine) {
+		engine.run(deadline);
+		cost = engine.best_value();
+		if (cost == LLONG_MIN)
+			return;
+		sides.resize(std::size_t(graph.size()));
+		for (std::size_t v = 0; v < sides.size(); v++)
+			sides[v] = side_at(engine.best_genome(), v);
+	}, options);
+	return cost;
+}
+
+} // namespace maxcut
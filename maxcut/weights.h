@@ -0,0 +1,112 @@
+#pragma once
+// Compact weight storage for the evaluation passes
+// Graph keeps every weight as an int, which the reductions (kernel, multilevel) need for their sums. The
+// evaluation passes only read weights, so they use a copy in the narrowest layout the weight range allows:
+// none at all when every weight is 1 (the cut is then a count of edges), int8 or int16 for small ranges, int32
+// otherwise. Loops are written once against a weight accessor (UnitWeights or a pointer to the stored type),
+// and visit() instantiates them for the graph's kind; sums are always accumulated in 64 bits.
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "graph.h"
+
+namespace maxcut {
+
+enum class WeightKind { unit, int8, int16, int32 };
+
+// Narrowest kind holding every weight of edges
+inline WeightKind weight_kind(const std::vector<Edge>& edges) {
+	bool unit = true;
+	int lo = 0, hi = 0;
+	for (const Edge& e : edges) {
+		unit &= e.w == 1;
+		lo = e.w < lo ? e.w : lo;
+		hi = e.w > hi ? e.w : hi;
+	}
+	if (unit)
+		return WeightKind::unit;
+	if (lo >= -128 && hi <= 127)
+		return WeightKind::int8;
+	if (lo >= -32768 && hi <= 32767)
+		return WeightKind::int16;
+	return WeightKind::int32;
+}
+
+// Bytes per stored weight
+inline std::size_t weight_bytes(WeightKind kind) {
+	return kind == WeightKind::unit ? 0 : kind == WeightKind::int8 ? 1 : kind == WeightKind::int16 ? 2 : 4;
+}
+
+// Weight accessor of an unweighted graph: nothing stored, nothing loaded
+struct UnitWeights {
+	constexpr int operator[](std::size_t) const { return 1; }
+};
+
+// A weight array in the layout of its kind
+class WeightArray {
+private:
+	WeightKind kind = WeightKind::unit;
+	std::vector<std::int8_t> w8;
+	std::vector<std::int16_t> w16;
+	std::vector<std::int32_t> w32;
+
+public:
+	WeightArray() = default;
+	// count weights from w, which must fit kind
+	WeightArray(WeightKind kind, const int* w, std::size_t count) : kind(kind) {
+		if (kind == WeightKind::int8)
+			w8.assign(w, w + count);
+		else if (kind == WeightKind::int16)
+			w16.assign(w, w + count);
+		else if (kind == WeightKind::int32)
+			w32.assign(w, w + count);
+	}
+
+	// f(weights) with weights a UnitWeights or a const pointer to the stored type
+	template <class F>
+	decltype(auto) visit(F&& f) const {
+		switch (kind) {
+		case WeightKind::int8:
+			return f(w8.data());
+		case WeightKind::int16:
+			return f(w16.data());
+		case WeightKind::int32:
+			return f(w32.data());
+		default:
+			return f(UnitWeights());
+		}
+	}
+};
+
+// Endpoints of an edge, without its weight
+struct EdgeEnds {
+	int u;
+	int v;
+};
+
+// The edges of a graph and its CSR weights, stored compactly. Built once per problem and shared (read-only)
+// by every copy of the evaluators.
+class CompactEdges {
+public:
+	WeightKind kind;
+	std::vector<EdgeEnds> ends; // endpoints of each undirected edge, as in Graph::edges
+	WeightArray edge_w; // parallel to ends
+	WeightArray adj_w; // parallel to Graph::adj; empty when built from an edge list
+
+public:
+	explicit CompactEdges(const std::vector<Edge>& edges) : kind(weight_kind(edges)), ends(edges.size()) {
+		std::vector<int> w(edges.size());
+		for (std::size_t i = 0; i < edges.size(); i++) {
+			ends[i] = EdgeEnds{ edges[i].u, edges[i].v };
+			w[i] = edges[i].w;
+		}
+		edge_w = WeightArray(kind, w.data(), w.size());
+	}
+	explicit CompactEdges(const Graph& graph) : CompactEdges(graph.edges) {
+		adj_w = WeightArray(kind, graph.adj_w.data(), graph.adj_w.size());
+	}
+
+	std::size_t size() const { return ends.size(); }
+};
+
+} // namespace maxcut